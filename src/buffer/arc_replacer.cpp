@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ArcReplacer::ArcReplacer(size_t num_frames) : replacer_size_(num_frames), frames_(num_frames) {}
+
+auto ArcReplacer::EvictableList(const FrameInfo &frame) -> std::set<std::pair<size_t, frame_id_t>> & {
+  return frame.list_ == ArcList::T1 ? t1_ : t2_;
+}
+
+void ArcReplacer::TrimGhosts() {
+  while (!b1_.empty() && t1_size_ + b1_.size() > replacer_size_) {
+    ghosts_.erase(b1_.front());
+    b1_.pop_front();
+  }
+  while (t1_size_ + t2_size_ + b1_.size() + b2_.size() > 2 * replacer_size_) {
+    auto &ghost_list = b2_.empty() ? b1_ : b2_;
+    ghosts_.erase(ghost_list.front());
+    ghost_list.pop_front();
+  }
+}
+
+auto ArcReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+
+  // REPLACE(p): shrink T1 while it is over its target, otherwise T2. Pinned frames cannot be evicted, so fall back
+  // to the other list when the preferred one has no evictable frame.
+  bool from_t1;
+  if (!t1_.empty() && (t1_size_ > target_t1_size_ || t2_.empty())) {
+    from_t1 = true;
+  } else if (!t2_.empty()) {
+    from_t1 = false;
+  } else {
+    return false;
+  }
+
+  auto &evictable = from_t1 ? t1_ : t2_;
+  *frame_id = evictable.begin()->second;
+  evictable.erase(evictable.begin());
+
+  auto &frame = frames_[*frame_id];
+  auto &ghost_list = from_t1 ? b1_ : b2_;
+  ghost_list.push_back(frame.page_id_);
+  ghosts_[frame.page_id_] = {!from_t1, std::prev(ghost_list.end())};
+  (from_t1 ? t1_size_ : t2_size_)--;
+  frame = FrameInfo{};
+
+  TrimGhosts();
+  return true;
+}
+
+void ArcReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
+
+  auto &frame = frames_[frame_id];
+
+  // cache hit: the page has now been seen at least twice, move it to the MRU end of T2
+  if (frame.list_ != ArcList::NONE) {
+    if (frame.evictable_) {
+      EvictableList(frame).erase({frame.last_access_, frame_id});
+    }
+    if (frame.list_ == ArcList::T1) {
+      t1_size_--;
+      t2_size_++;
+      frame.list_ = ArcList::T2;
+    }
+    frame.last_access_ = current_timestamp_++;
+    if (frame.evictable_) {
+      t2_.emplace(frame.last_access_, frame_id);
+    }
+    return;
+  }
+
+  // cache miss: the page was just loaded into the frame, adapt p if we evicted it too early
+  auto ghost = ghosts_.find(page_id);
+  if (ghost == ghosts_.end()) {
+    frame.list_ = ArcList::T1;
+    t1_size_++;
+  } else {
+    if (!ghost->second.first) {
+      size_t delta = std::max<size_t>(b2_.size() / b1_.size(), 1);
+      target_t1_size_ = std::min(target_t1_size_ + delta, replacer_size_);
+      b1_.erase(ghost->second.second);
+    } else {
+      size_t delta = std::max<size_t>(b1_.size() / b2_.size(), 1);
+      target_t1_size_ = target_t1_size_ > delta ? target_t1_size_ - delta : 0;
+      b2_.erase(ghost->second.second);
+    }
+    ghosts_.erase(ghost);
+    frame.list_ = ArcList::T2;
+    t2_size_++;
+  }
+  frame.page_id_ = page_id;
+  frame.last_access_ = current_timestamp_++;
+
+  TrimGhosts();
+}
+
+void ArcReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
+
+  auto &frame = frames_[frame_id];
+  if (frame.list_ == ArcList::NONE || frame.evictable_ == set_evictable) {
+    return;
+  }
+  if (set_evictable) {
+    EvictableList(frame).emplace(frame.last_access_, frame_id);
+  } else {
+    EvictableList(frame).erase({frame.last_access_, frame_id});
+  }
+  frame.evictable_ = set_evictable;
+}
+
+void ArcReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
+
+  auto &frame = frames_[frame_id];
+  if (frame.list_ == ArcList::NONE) {
+    return;
+  }
+  BUSTUB_ASSERT(frame.evictable_, "Remove failed: Removal called on a non-evictable frame");
+
+  EvictableList(frame).erase({frame.last_access_, frame_id});
+  (frame.list_ == ArcList::T1 ? t1_size_ : t2_size_)--;
+  frame = FrameInfo{};
+}
+
+auto ArcReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return t1_.size() + t2_.size();
+}
+
+auto ArcReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // assume the list Evict() would pick now keeps being picked until it runs out of evictable frames
+  bool t1_first = !t1_.empty() && (t1_size_ > target_t1_size_ || t2_.empty());
+  std::vector<frame_id_t> candidates;
+  for (const auto *list : {t1_first ? &t1_ : &t2_, t1_first ? &t2_ : &t1_}) {
+    for (auto it = list->begin(); it != list->end() && candidates.size() < max_frames; ++it) {
+      candidates.push_back(it->second);
+    }
+  }
+  return candidates;
+}
+
+}  // namespace bustub
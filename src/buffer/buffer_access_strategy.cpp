@@ -0,0 +1,41 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.cpp
+//
+// Identification: src/buffer/buffer_access_strategy.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_access_strategy.h"
+
+namespace bustub {
+
+BufferAccessStrategy::BufferAccessStrategy(size_t ring_size) : ring_size_(ring_size) {
+  BUSTUB_ASSERT(ring_size > 0, "ring size should be positive");
+}
+
+auto BufferAccessStrategy::GetRecyclePage(uint32_t instance_index) -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &ring = rings_[instance_index];
+  if (ring.pages_.size() < ring_size_) {
+    return INVALID_PAGE_ID;
+  }
+  return ring.pages_[ring.next_slot_];
+}
+
+void BufferAccessStrategy::RecordLoad(uint32_t instance_index, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &ring = rings_[instance_index];
+  if (ring.pages_.size() < ring_size_) {
+    ring.pages_.push_back(page_id);
+    return;
+  }
+  ring.pages_[ring.next_slot_] = page_id;
+  ring.next_slot_ = (ring.next_slot_ + 1) % ring_size_;
+}
+
+}  // namespace bustub
@@ -12,18 +12,68 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/two_queue_replacer.h"
 #include "common/exception.h"
+#include "common/logger.h"
 #include "common/macros.h"
 
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
+                                                     LogManager *log_manager, ReplacerType replacer_type,
+                                                     bool use_huge_pages)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, replacer_k, log_manager, replacer_type,
+                                use_huge_pages) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, ReplacerType replacer_type,
+                                                     bool use_huge_pages)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 0.");
   // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  page_table_ = new ExtendibleHashTable<page_id_t, frame_id_t>(bucket_size_);
-  replacer_ = new LRUKReplacer(pool_size, replacer_k);
+  AllocateFrames(use_huge_pages);
+  pages_ = static_cast<Page *>(::operator new(pool_size_ * sizeof(Page)));
+  for (size_t i = 0; i < pool_size_; ++i) {
+    new (&pages_[i]) Page(frames_ + i * BUSTUB_PAGE_SIZE);
+  }
+  page_table_ = new LinearProbePageTable(pool_size_);
+  switch (replacer_type) {
+    case ReplacerType::LRU:
+      replacer_ = new LRUReplacer(pool_size);
+      break;
+    case ReplacerType::CLOCK:
+      replacer_ = new ClockReplacer(pool_size);
+      break;
+    case ReplacerType::ARC:
+      replacer_ = new ArcReplacer(pool_size);
+      break;
+    case ReplacerType::TWO_QUEUE:
+      replacer_ = new TwoQueueReplacer(pool_size);
+      break;
+    case ReplacerType::LRUK:
+      replacer_ = new LRUKReplacer(pool_size, replacer_k);
+      break;
+  }
+  io_state_.resize(pool_size_, FrameIoState::NONE);
+  dirty_counts_.resize(pool_size_, 0);
+  io_cv_ = std::make_unique<std::condition_variable[]>(pool_size_);
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
@@ -32,13 +82,75 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManag
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
-  delete[] pages_;
+  StopBackgroundWriter();
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].~Page();
+  }
+  ::operator delete(pages_);
+  if (frames_mapped_) {
+    munmap(frames_, frames_size_);
+  } else {
+    std::free(frames_);  // NOLINT
+  }
   delete page_table_;
   delete replacer_;
 }
 
-auto BufferPoolManagerInstance::PickReplacementFrame(frame_id_t *frame_id) -> bool {
+void BufferPoolManagerInstance::AllocateFrames(bool use_huge_pages) {
+  frames_size_ = pool_size_ * BUSTUB_PAGE_SIZE;
+  if (use_huge_pages) {
+    auto mapped_size = (frames_size_ + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    // explicit huge pages if the administrator reserved some, transparent huge pages otherwise
+    void *frames = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (frames == MAP_FAILED) {
+      frames = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (frames != MAP_FAILED) {
+        madvise(frames, mapped_size, MADV_HUGEPAGE);
+      }
+    }
+    if (frames != MAP_FAILED) {
+      frames_ = static_cast<char *>(frames);
+      frames_size_ = mapped_size;
+      frames_mapped_ = true;
+      return;
+    }
+    LOG_DEBUG("could not map huge pages for the buffer pool");
+  }
+  frames_ = static_cast<char *>(std::aligned_alloc(BUSTUB_PAGE_SIZE, frames_size_));  // NOLINT
+  if (frames_ == nullptr) {
+    throw std::bad_alloc();
+  }
+}
+
+auto BufferPoolManagerInstance::GetNumFreeFrames() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return free_list_.size() + replacer_->Size();
+}
+
+auto BufferPoolManagerInstance::HasReplaceableFrame() -> bool { return !free_list_.empty() || replacer_->Size() > 0; }
+
+auto BufferPoolManagerInstance::PickReplacementFrame(frame_id_t *frame_id, page_id_t *dirty_page_id,
+                                                     BufferAccessStrategy *strategy) -> bool {
   frame_id_t lookup_frame = -1;
+  *dirty_page_id = INVALID_PAGE_ID;
+
+  // a bulk read recycles the frame of the oldest page of its ring, unless someone else is using that page now
+  if (strategy != nullptr) {
+    auto recycle_page_id = strategy->GetRecyclePage(instance_index_);
+    if (recycle_page_id != INVALID_PAGE_ID && page_table_->Find(recycle_page_id, lookup_frame) &&
+        pages_[lookup_frame].GetPinCount() == 0 && io_state_[lookup_frame] == FrameIoState::NONE) {
+      replacer_->Remove(lookup_frame);
+      if (pages_[lookup_frame].IsDirty()) {
+        *dirty_page_id = recycle_page_id;
+        SetDirty(lookup_frame, false);
+      }
+      page_table_->Remove(recycle_page_id);
+      stats_.AddEviction();
+      *frame_id = lookup_frame;
+      return true;
+    }
+  }
+
   // first lookup frame managed by buffer pool
   if (!free_list_.empty()) {
     lookup_frame = free_list_.front();
@@ -50,12 +162,14 @@ auto BufferPoolManagerInstance::PickReplacementFrame(frame_id_t *frame_id) -> bo
   // no free in the free list, evict saved frame from buffer pool
   if (replacer_->Evict(&lookup_frame)) {
     auto evicted_page_id = pages_[lookup_frame].GetPageId();
+    // the writeback itself is done by LoadFrame() without holding the latch
     if (pages_[lookup_frame].IsDirty()) {
-      disk_manager_->WritePage(evicted_page_id, pages_[lookup_frame].GetData());
-      pages_[lookup_frame].is_dirty_ = false;
+      *dirty_page_id = evicted_page_id;
+      SetDirty(lookup_frame, false);
     }
 
     page_table_->Remove(evicted_page_id);
+    stats_.AddEviction();
     *frame_id = lookup_frame;
 
     return true;
@@ -63,68 +177,297 @@ auto BufferPoolManagerInstance::PickReplacementFrame(frame_id_t *frame_id) -> bo
   return false;
 }
 
-auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
+auto BufferPoolManagerInstance::LoadFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_id,
+                                          page_id_t dirty_page_id, bool read_from_disk, bool read_only) -> bool {
+  Page *page = &pages_[frame_id];
+
+  if (dirty_page_id != INVALID_PAGE_ID) {
+    // fetchers of the evicted page must not read it from disk before this write lands
+    io_state_[frame_id] = FrameIoState::WRITING;
+    writeback_pages_.emplace(dirty_page_id, frame_id);
+    lock->unlock();
+    const bool written = disk_manager_->WritePage(dirty_page_id, page->GetData());
+    lock->lock();
+    if (!written) {
+      // the evicted page takes its frame back and stays dirty, fetchers of the new page see the frame change hands
+      page_table_->Remove(page->GetPageId());
+      page_table_->Insert(dirty_page_id, frame_id);
+      page->page_id_ = dirty_page_id;
+      page->pin_count_--;
+      SetDirty(frame_id, true);
+      writeback_pages_.erase(dirty_page_id);
+      io_state_[frame_id] = FrameIoState::NONE;
+      io_cv_[frame_id].notify_all();
+      if (page->GetPinCount() == 0) {
+        replacer_->SetEvictable(frame_id, true);
+      }
+      return false;
+    }
+    writeback_pages_.erase(dirty_page_id);
+    io_cv_[frame_id].notify_all();
+    stats_.AddWritebacks(1);
+  }
+
+  // a page of a mapped database file that is only read is used in place, there is nothing to read
+  UseFrameData(frame_id);
+  const char *mapped_data = read_from_disk && read_only ? disk_manager_->GetMappedPage(page->GetPageId()) : nullptr;
+  if (mapped_data != nullptr) {
+    page->data_ = const_cast<char *>(mapped_data);
+  } else if (read_from_disk) {
+    io_state_[frame_id] = FrameIoState::READING;
+    lock->unlock();
+    disk_manager_->ReadPage(page->GetPageId(), page->GetData());
+    lock->lock();
+  } else {
+    page->ResetMemory();
+  }
+
+  io_state_[frame_id] = FrameIoState::NONE;
+  io_cv_[frame_id].notify_all();
+  return true;
+}
+
+auto BufferPoolManagerInstance::FlushFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_id, page_id_t page_id)
+    -> bool {
+  io_cv_[frame_id].wait(*lock, [&] { return io_state_[frame_id] == FrameIoState::NONE; });
+  // the page may have been evicted or deleted while another I/O on the frame was waited for
+  if (pages_[frame_id].GetPageId() != page_id) {
+    return false;
+  }
+
+  // like in LoadFrame(), fetchers of the page wait for the write to land, and the frame cannot be evicted meanwhile
+  replacer_->SetEvictable(frame_id, false);
+  io_state_[frame_id] = FrameIoState::WRITING;
+  const uint64_t dirty_count = dirty_counts_[frame_id];
+  lock->unlock();
+  const bool succeeded = disk_manager_->WritePageAsync(page_id, pages_[frame_id].GetData()).Wait();
+  lock->lock();
+
+  // a failed write keeps the page dirty, and so does a change a pin holder made during the write
+  if (succeeded && dirty_counts_[frame_id] == dirty_count) {
+    SetDirty(frame_id, false);
+  }
+  io_state_[frame_id] = FrameIoState::NONE;
+  io_cv_[frame_id].notify_all();
+  if (pages_[frame_id].GetPinCount() == 0) {
+    replacer_->SetEvictable(frame_id, true);
+  }
+  if (succeeded) {
+    stats_.AddFlushes(1);
+  }
+  return succeeded;
+}
+
+void BufferPoolManagerInstance::SetDirty(frame_id_t frame_id, bool is_dirty) {
+  if (is_dirty) {
+    dirty_counts_[frame_id]++;
+  }
+  if (pages_[frame_id].is_dirty_ == is_dirty) {
+    return;
+  }
+  if (is_dirty) {
+    num_dirty_frames_++;
+  } else {
+    num_dirty_frames_--;
+  }
+  pages_[frame_id].is_dirty_ = is_dirty;
+}
+
+void BufferPoolManagerInstance::RunBackgroundWriter(const BackgroundWriterOptions &options) {
   std::scoped_lock<std::mutex> lock(latch_);
+  if (background_writer_running_) {
+    return;
+  }
+  background_writer_running_ = true;
+  background_writer_ = std::thread([this, options] {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (background_writer_running_) {
+      BackgroundWriterRound(&lock, options);
+      background_writer_cv_.wait_for(lock, options.interval_, [&] { return !background_writer_running_; });
+    }
+  });
+}
 
-  // whole pages were used
-  bool has_free = false;
-  for (size_t i = 0; i < pool_size_; i++) {
-    if (pages_[i].GetPinCount() == 0) {
-      has_free = true;
+void BufferPoolManagerInstance::StopBackgroundWriter() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (!background_writer_running_) {
+      return;
+    }
+    background_writer_running_ = false;
+    background_writer_cv_.notify_all();
+  }
+  background_writer_.join();
+}
+
+auto BufferPoolManagerInstance::BackgroundWriterRound(std::unique_lock<std::mutex> *lock,
+                                                      const BackgroundWriterOptions &options) -> size_t {
+  if (static_cast<double>(num_dirty_frames_) <= options.dirty_ratio_threshold_ * static_cast<double>(pool_size_)) {
+    return 0;
+  }
+
+  // the frames to write, with the number of times each page was dirtied so far, like in BeginFlush()
+  std::vector<std::pair<frame_id_t, uint64_t>> frames;
+  for (auto frame_id : replacer_->EvictionCandidates(options.lookahead_)) {
+    if (frames.size() >= options.max_pages_per_round_) {
       break;
     }
+    Page *page = &pages_[frame_id];
+    if (!page->IsDirty() || page->GetPinCount() > 0 || io_state_[frame_id] != FrameIoState::NONE) {
+      continue;
+    }
+    // fetchers of the page wait for the write to land, and the frame cannot be evicted meanwhile
+    replacer_->SetEvictable(frame_id, false);
+    io_state_[frame_id] = FrameIoState::WRITING;
+    frames.emplace_back(frame_id, dirty_counts_[frame_id]);
   }
-  if (!has_free) {
-    return nullptr;
+  if (frames.empty()) {
+    return 0;
   }
 
-  *page_id = AllocatePage();
+  // queue the whole round at once so an asynchronous disk manager can keep all of it in flight
+  lock->unlock();
+  std::vector<DiskRequest> requests;
+  requests.reserve(frames.size());
+  for (const auto &[frame_id, dirty_count] : frames) {
+    requests.push_back(disk_manager_->WritePageAsync(pages_[frame_id].GetPageId(), pages_[frame_id].GetData()));
+  }
+  disk_manager_->SubmitAsyncIo();
+  std::vector<bool> succeeded;
+  succeeded.reserve(requests.size());
+  for (auto &request : requests) {
+    succeeded.push_back(request.Wait());
+  }
+  lock->lock();
+
+  size_t num_written = 0;
+  for (size_t i = 0; i < frames.size(); i++) {
+    const auto &[frame_id, dirty_count] = frames[i];
+    // a failed write leaves the page dirty, so its changes are written by a later round or the eviction
+    if (succeeded[i] && dirty_counts_[frame_id] == dirty_count) {
+      SetDirty(frame_id, false);
+      num_written++;
+    }
+    io_state_[frame_id] = FrameIoState::NONE;
+    io_cv_[frame_id].notify_all();
+    if (pages_[frame_id].GetPinCount() == 0) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+  stats_.AddWritebacks(num_written);
+  return num_written;
+}
+
+auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
+  return NewPgNearImp(page_id, INVALID_PAGE_ID);
+}
+
+auto BufferPoolManagerInstance::NewPgNearImp(page_id_t *page_id, page_id_t hint) -> Page * {
+  return NewPgInternal(page_id, hint, nullptr);
+}
+
+auto BufferPoolManagerInstance::NewPgInExtentImp(page_id_t *page_id, ExtentAllocator *extents) -> Page * {
+  return NewPgInternal(page_id, INVALID_PAGE_ID, extents);
+}
+
+auto BufferPoolManagerInstance::NewPgInternal(page_id_t *page_id, page_id_t hint, ExtentAllocator *extents)
+    -> Page * {
+  std::unique_lock<std::mutex> lock(latch_);
 
   frame_id_t lookup_frame = -1;
-  if (!PickReplacementFrame(&lookup_frame)) {
+  page_id_t dirty_page_id = INVALID_PAGE_ID;
+  // whole pages were used
+  if (!HasReplaceableFrame() || !PickReplacementFrame(&lookup_frame, &dirty_page_id)) {
+    stats_.AddPinFailure();
     return nullptr;
   }
 
+  bool reused = false;
+  *page_id = AllocatePage(hint, extents, &reused);
+
   // now frame was available, save data "to" frame
   page_table_->Insert(*page_id, lookup_frame);
 
-  pages_[lookup_frame].ResetMemory();
   pages_[lookup_frame].page_id_ = *page_id;
   pages_[lookup_frame].pin_count_ = 1;
+  if (reused) {
+    // the zeroed page must replace what the deallocated page left on disk, even if the caller never dirties it
+    SetDirty(lookup_frame, true);
+  }
 
-  replacer_->RecordAccess(lookup_frame);
+  replacer_->RecordAccess(lookup_frame, *page_id);
   replacer_->SetEvictable(lookup_frame, false);
 
+  if (!LoadFrame(&lock, lookup_frame, dirty_page_id, false)) {
+    DeallocatePage(*page_id);
+    return nullptr;
+  }
+
   return &pages_[lookup_frame];
 }
 
 auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
-  std::scoped_lock<std::mutex> lock(latch_);
+  return FetchPgWithStrategyImp(page_id, nullptr);
+}
+
+auto BufferPoolManagerInstance::FetchPgWithStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  return FetchPgInternal(page_id, strategy, false);
+}
+
+auto BufferPoolManagerInstance::FetchPgReadOnlyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  return FetchPgInternal(page_id, strategy, true);
+}
+
+auto BufferPoolManagerInstance::FetchPgInternal(page_id_t page_id, BufferAccessStrategy *strategy, bool read_only)
+    -> Page * {
+  // declared before the lock, so the fetch is timed until the latch is released
+  BufferPoolStats::FetchTimer timer(&stats_);
+  std::unique_lock<std::mutex> lock(latch_);
 
   frame_id_t lookup_frame = -1;
-  if (page_table_->Find(page_id, lookup_frame)) {
+  while (true) {
+    bool found = page_table_->Find(page_id, lookup_frame);
+    while (!found && writeback_pages_.count(page_id) > 0) {
+      // the page was just evicted and is still being written back, wait until it is on disk
+      io_cv_[writeback_pages_[page_id]].wait(lock, [&] { return writeback_pages_.count(page_id) == 0; });
+      found = page_table_->Find(page_id, lookup_frame);
+    }
+    if (!found) {
+      break;
+    }
+
     pages_[lookup_frame].pin_count_++;
-    replacer_->RecordAccess(lookup_frame);
+    replacer_->RecordAccess(lookup_frame, page_id);
     replacer_->SetEvictable(lookup_frame, false);
-    return &pages_[lookup_frame];
+    // another thread may still be loading the page into this frame
+    io_cv_[lookup_frame].wait(lock, [&] { return io_state_[lookup_frame] == FrameIoState::NONE; });
+    if (pages_[lookup_frame].GetPageId() == page_id) {
+      stats_.AddHit();
+      if (!read_only && IsFrameMapped(lookup_frame)) {
+        // the page may be modified now, it moves out of the read-only mapping into the frame. Readers that still use
+        // the mapped page see the same data, the file only changes when the frame's copy is written back
+        memcpy(frames_ + lookup_frame * BUSTUB_PAGE_SIZE, pages_[lookup_frame].GetData(), BUSTUB_PAGE_SIZE);
+        UseFrameData(lookup_frame);
+      }
+      return &pages_[lookup_frame];
+    }
+    // the frame went back to the page it was evicting because that write failed, look the page up again
+    if (--pages_[lookup_frame].pin_count_ == 0) {
+      replacer_->SetEvictable(lookup_frame, true);
+    }
   }
 
   /* from now, means page not exist in buffer pool */
+  stats_.AddMiss();
 
+  page_id_t dirty_page_id = INVALID_PAGE_ID;
   // pinned
-  bool has_free = false;
-  for (size_t i = 0; i < pool_size_; i++) {
-    if (pages_[i].GetPinCount() == 0) {
-      has_free = true;
-      break;
-    }
-  }
-  if (!has_free) {
+  if (!HasReplaceableFrame() || !PickReplacementFrame(&lookup_frame, &dirty_page_id, strategy)) {
+    stats_.AddPinFailure();
     return nullptr;
   }
-
-  if (!PickReplacementFrame(&lookup_frame)) {
-    return nullptr;
+  if (strategy != nullptr) {
+    strategy->RecordLoad(instance_index_, page_id);
   }
 
   // now frame was available, save data "to" frame
@@ -133,12 +476,14 @@ auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
   pages_[lookup_frame].page_id_ = page_id;
   pages_[lookup_frame].pin_count_ = 1;
 
-  // load legacy data
-  disk_manager_->ReadPage(page_id, pages_[lookup_frame].GetData());
-
-  replacer_->RecordAccess(lookup_frame);
+  replacer_->RecordAccess(lookup_frame, page_id);
   replacer_->SetEvictable(lookup_frame, false);
 
+  // load legacy data
+  if (!LoadFrame(&lock, lookup_frame, dirty_page_id, true, read_only)) {
+    return nullptr;
+  }
+
   return &pages_[lookup_frame];
 }
 
@@ -156,12 +501,13 @@ auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) ->
 
   pages_[lookup_frame].pin_count_--;
 
-  if (pages_[lookup_frame].pin_count_ == 0) {
+  // a frame that is being flushed becomes evictable once the write landed, see EndFlush()
+  if (pages_[lookup_frame].pin_count_ == 0 && io_state_[lookup_frame] == FrameIoState::NONE) {
     replacer_->SetEvictable(lookup_frame, true);
   }
 
   if (is_dirty) {
-    pages_[lookup_frame].is_dirty_ = is_dirty;
+    SetDirty(lookup_frame, true);
   }
   return true;
 }
@@ -171,29 +517,100 @@ auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
     return false;
   }
 
+  std::unique_lock<std::mutex> lock(latch_);
+
   frame_id_t lookup_frame = -1;
   if (page_table_->Find(page_id, lookup_frame)) {
-    disk_manager_->WritePage(page_id, pages_[lookup_frame].GetData());
-    pages_[lookup_frame].is_dirty_ = false;
-    return true;
+    return FlushFrame(&lock, lookup_frame, page_id);
   }
 
   return false;
 }
 
 void BufferPoolManagerInstance::FlushAllPgsImp() {
-  std::scoped_lock<std::mutex> lock(latch_);
+  // the order of the frames says nothing about where their pages are, so sort the dirty pages of the whole pool first
+  auto dirty_pages = CollectDirtyPages();
+  std::sort(dirty_pages.begin(), dirty_pages.end());
+  for (size_t first = 0; first < dirty_pages.size(); first += FLUSH_CHUNK_SIZE) {
+    std::vector<std::pair<page_id_t, frame_id_t>> chunk(
+        dirty_pages.begin() + first, dirty_pages.begin() + std::min(first + FLUSH_CHUNK_SIZE, dirty_pages.size()));
+    std::vector<std::pair<page_id_t, const char *>> batch;
+    auto frames = BeginFlush(chunk, &batch);
+    EndFlush(frames, disk_manager_->WritePageBatch(&batch));
+  }
+}
 
+auto BufferPoolManagerInstance::CollectDirtyPages() -> std::vector<std::pair<page_id_t, frame_id_t>> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<std::pair<page_id_t, frame_id_t>> dirty_pages;
+  dirty_pages.reserve(num_dirty_frames_);
   for (size_t i = 0; i < pool_size_; i++) {
-    FlushPgImp(i);
+    if (pages_[i].IsDirty() && pages_[i].GetPageId() != INVALID_PAGE_ID) {
+      dirty_pages.emplace_back(pages_[i].GetPageId(), static_cast<frame_id_t>(i));
+    }
   }
+  return dirty_pages;
 }
 
-auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
+auto BufferPoolManagerInstance::BeginFlush(const std::vector<std::pair<page_id_t, frame_id_t>> &pages,
+                                           std::vector<std::pair<page_id_t, const char *>> *batch)
+    -> std::vector<std::pair<frame_id_t, uint64_t>> {
+  std::unique_lock<std::mutex> lock(latch_);
+
+  std::vector<std::pair<frame_id_t, uint64_t>> frames;
+  for (const auto &[page_id, frame_id] : pages) {
+    io_cv_[frame_id].wait(lock, [&, frame_id = frame_id] { return io_state_[frame_id] == FrameIoState::NONE; });
+    // the page may have been evicted or written back since it was collected
+    if (pages_[frame_id].GetPageId() != page_id || !pages_[frame_id].IsDirty()) {
+      continue;
+    }
+    // like in BackgroundWriterRound(), fetchers wait for the write to land, and the frame cannot be evicted meanwhile
+    replacer_->SetEvictable(frame_id, false);
+    io_state_[frame_id] = FrameIoState::WRITING;
+    frames.emplace_back(frame_id, dirty_counts_[frame_id]);
+    batch->emplace_back(page_id, pages_[frame_id].GetData());
+  }
+  return frames;
+}
+
+void BufferPoolManagerInstance::EndFlush(const std::vector<std::pair<frame_id_t, uint64_t>> &frames, bool succeeded) {
   std::scoped_lock<std::mutex> lock(latch_);
+  for (const auto &[frame_id, dirty_count] : frames) {
+    // a page that a pin holder dirtied again during the write has changes that may not be on disk
+    if (succeeded && dirty_counts_[frame_id] == dirty_count) {
+      SetDirty(frame_id, false);
+    }
+    io_state_[frame_id] = FrameIoState::NONE;
+    io_cv_[frame_id].notify_all();
+    if (pages_[frame_id].GetPinCount() == 0) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+  if (succeeded) {
+    stats_.AddFlushes(frames.size());
+  }
+}
+
+auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
+  if (page_id < 0) {
+    // there is no such page, so there is nothing to delete
+    return true;
+  }
+  std::unique_lock<std::mutex> lock(latch_);
 
   frame_id_t lookup_frame = -1;
-  if (!page_table_->Find(page_id, lookup_frame)) {
+  bool found = page_table_->Find(page_id, lookup_frame);
+  while (found && io_state_[lookup_frame] != FrameIoState::NONE) {
+    // the page is being loaded, or written out by the background writer
+    io_cv_[lookup_frame].wait(lock);
+    found = page_table_->Find(page_id, lookup_frame);
+  }
+  if (!found) {
+    // a writeback of the evicted page must land before the page can be handed out again
+    while (writeback_pages_.count(page_id) > 0) {
+      io_cv_[writeback_pages_[page_id]].wait(lock, [&] { return writeback_pages_.count(page_id) == 0; });
+    }
+    DeallocatePage(page_id);
     return true;
   }
 
@@ -205,15 +622,40 @@ auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
   replacer_->Remove(lookup_frame);
   free_list_.push_back(lookup_frame);
 
+  UseFrameData(lookup_frame);
   pages_[lookup_frame].ResetMemory();
   pages_[lookup_frame].page_id_ = INVALID_PAGE_ID;
-  pages_[lookup_frame].is_dirty_ = false;
+  SetDirty(lookup_frame, false);
   pages_[lookup_frame].pin_count_ = 0;
 
   DeallocatePage(page_id);
   return true;
 }
 
-auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { return next_page_id_++; }
+void BufferPoolManagerInstance::AdviseAccessPatternImp(page_id_t first_page_id, size_t num_pages,
+                                                       AccessPattern pattern) {
+  disk_manager_->AdviseAccessPattern(first_page_id, num_pages, pattern);
+}
+
+auto BufferPoolManagerInstance::AllocatePage(page_id_t hint, ExtentAllocator *extents, bool *reused) -> page_id_t {
+  if (extents != nullptr) {
+    const page_id_t extent_page_id = extents->AllocatePage(disk_manager_, num_instances_, instance_index_, reused);
+    ValidatePageId(extent_page_id);
+    return extent_page_id;
+  }
+  const page_id_t free_page_id = disk_manager_->AllocateFreePage(hint, num_instances_, instance_index_);
+  *reused = free_page_id != INVALID_PAGE_ID;
+  if (*reused) {
+    return free_page_id;
+  }
+  const page_id_t next_page_id = disk_manager_->AllocateNewPage(num_instances_, instance_index_);
+  ValidatePageId(next_page_id);
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  // allocated pages mod back to this BPI
+  BUSTUB_ASSERT(page_id % num_instances_ == instance_index_, "page_id is routed to the wrong BPI");
+}
 
 }  // namespace bustub
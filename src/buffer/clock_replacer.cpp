@@ -14,16 +14,95 @@
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages)
+    : replacer_size_(num_pages),
+      states_(std::make_unique<std::atomic<FrameState>[]>(num_pages)),
+      ref_bits_(std::make_unique<std::atomic<bool>[]>(num_pages)) {
+  for (size_t i = 0; i < num_pages; i++) {
+    states_[i].store(FrameState::UNTRACKED, std::memory_order_relaxed);
+    ref_bits_[i].store(false, std::memory_order_relaxed);
+  }
+}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto ClockReplacer::Transition(frame_id_t frame_id, FrameState expected, FrameState desired) -> bool {
+  return states_[frame_id].compare_exchange_strong(expected, desired, std::memory_order_acq_rel);
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool {
+  // keep sweeping while there is anything to evict: every evictable frame is claimed at the latest on the second
+  // pass, unless it keeps being referenced in between
+  while (curr_size_.load(std::memory_order_acquire) > 0) {
+    auto candidate = static_cast<frame_id_t>(hand_.fetch_add(1, std::memory_order_relaxed) % replacer_size_);
+    if (states_[candidate].load(std::memory_order_acquire) != FrameState::EVICTABLE) {
+      continue;
+    }
+    if (ref_bits_[candidate].load(std::memory_order_relaxed)) {
+      ref_bits_[candidate].store(false, std::memory_order_relaxed);
+      continue;
+    }
+    if (Transition(candidate, FrameState::EVICTABLE, FrameState::UNTRACKED)) {
+      curr_size_.fetch_sub(1, std::memory_order_acq_rel);
+      *frame_id = candidate;
+      return true;
+    }
+  }
+  return false;
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
+  ref_bits_[frame_id].store(true, std::memory_order_relaxed);
+  if (states_[frame_id].load(std::memory_order_relaxed) == FrameState::UNTRACKED) {
+    Transition(frame_id, FrameState::UNTRACKED, FrameState::PINNED);
+  }
+}
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
+  if (set_evictable) {
+    if (Transition(frame_id, FrameState::PINNED, FrameState::EVICTABLE)) {
+      curr_size_.fetch_add(1, std::memory_order_acq_rel);
+    }
+  } else {
+    if (Transition(frame_id, FrameState::EVICTABLE, FrameState::PINNED)) {
+      curr_size_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  }
+}
+
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
+  BUSTUB_ASSERT(states_[frame_id].load(std::memory_order_acquire) != FrameState::PINNED,
+                "Remove failed: Removal called on a non-evictable frame");
+  if (Transition(frame_id, FrameState::EVICTABLE, FrameState::UNTRACKED)) {
+    curr_size_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+auto ClockReplacer::Size() -> size_t { return curr_size_.load(std::memory_order_acquire); }
+
+auto ClockReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  // one sweep from the hand: frames with a clear reference bit go on the first pass, the others on the second
+  std::vector<frame_id_t> candidates;
+  std::vector<frame_id_t> referenced;
+  auto hand = hand_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < replacer_size_ && candidates.size() < max_frames; i++) {
+    auto frame_id = static_cast<frame_id_t>((hand + i) % replacer_size_);
+    if (states_[frame_id].load(std::memory_order_acquire) != FrameState::EVICTABLE) {
+      continue;
+    }
+    if (ref_bits_[frame_id].load(std::memory_order_relaxed)) {
+      referenced.push_back(frame_id);
+    } else {
+      candidates.push_back(frame_id);
+    }
+  }
+  for (size_t i = 0; i < referenced.size() && candidates.size() < max_frames; i++) {
+    candidates.push_back(referenced[i]);
+  }
+  return candidates;
+}
 
 }  // namespace bustub
@@ -14,63 +14,47 @@
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k), frames_(num_frames) {}
+
+auto LRUKReplacer::GetEvictKey(frame_id_t frame_id) const -> EvictKey {
+  const auto &history = frames_[frame_id].history_;
+  return {history.size() >= k_, history.front(), frame_id};
+}
 
 auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
   std::scoped_lock<std::mutex> lock(latch_);
 
-  // trverse history first, then cache
-  bool found_victim = false;
-  // since we insert from earlist to oldest, we trverse backwards
-  for (auto it = history_list_.rbegin(); it != history_list_.rend(); it++) {
-    if (data_[*it].evictable_) {
-      *frame_id = *it;
-      std::advance(it, 1);
-      // remove a reverse iterator
-      history_list_.erase(it.base());
-      found_victim = true;
-      break;
-    }
+  if (evict_index_.empty()) {
+    return false;
   }
 
-  if (!found_victim && !cache_list_.empty()) {
-    for (auto it = cache_list_.rbegin(); it != cache_list_.rend(); it++) {
-      if (data_[*it].evictable_) {
-        *frame_id = *it;
-        std::advance(it, 1);
-        cache_list_.erase(it.base());
-        found_victim = true;
-        break;
-      }
-    }
-  }
+  // the first key has +inf distance and the earliest access, or the largest backward k-distance
+  *frame_id = std::get<2>(*evict_index_.begin());
+  evict_index_.erase(evict_index_.begin());
 
-  if (found_victim) {
-    data_.erase(*frame_id);
-    curr_size_--;
-    return true;
-  }
-  return false;
+  frames_[*frame_id].history_.clear();
+  frames_[*frame_id].evictable_ = false;
+  curr_size_--;
+  return true;
 }
 
 void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
   std::scoped_lock<std::mutex> lock(latch_);
   BUSTUB_ASSERT(frame_id < (int)replacer_size_, "frame id is invalid: frame_id larger than replacer_size_");
 
-  auto new_cnt = ++data_[frame_id].use_count_;
-  if (new_cnt == 1) {  // new data
-    history_list_.emplace_front(frame_id);
-    data_[frame_id].pos_ = history_list_.begin();
-  } else if (new_cnt == k_) {
-    // equals to k, remove from history, save to cache
-    history_list_.erase(data_[frame_id].pos_);
-    cache_list_.emplace_front(frame_id);
-    data_[frame_id].pos_ = cache_list_.begin();
-  } else if (new_cnt > k_) {
-    // so popular, move to cache front
-    cache_list_.erase(data_[frame_id].pos_);
-    cache_list_.emplace_front(frame_id);
-    data_[frame_id].pos_ = cache_list_.begin();
+  auto &frame = frames_[frame_id];
+  // the key depends on the history, so re-index evictable frames around the update
+  if (frame.evictable_) {
+    evict_index_.erase(GetEvictKey(frame_id));
+  }
+
+  frame.history_.push_back(current_timestamp_++);
+  if (frame.history_.size() > k_) {
+    frame.history_.pop_front();
+  }
+
+  if (frame.evictable_) {
+    evict_index_.insert(GetEvictKey(frame_id));
   }
 }
 
@@ -78,39 +62,48 @@ void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
   std::scoped_lock<std::mutex> lock(latch_);
   BUSTUB_ASSERT(frame_id < (int)replacer_size_, "frame id is invalid: frame_id larger than replacer_size_");
 
-  if (data_.find(frame_id) == data_.end()) {
+  auto &frame = frames_[frame_id];
+  if (frame.history_.empty() || frame.evictable_ == set_evictable) {
     return;
   }
 
-  if (!data_[frame_id].evictable_ && set_evictable) {
+  if (set_evictable) {
+    evict_index_.insert(GetEvictKey(frame_id));
     curr_size_++;
-  }
-  if (data_[frame_id].evictable_ && !set_evictable) {
+  } else {
+    evict_index_.erase(GetEvictKey(frame_id));
     curr_size_--;
   }
 
-  data_[frame_id].evictable_ = set_evictable;
+  frame.evictable_ = set_evictable;
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
   std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < (int)replacer_size_, "frame id is invalid: frame_id larger than replacer_size_");
 
-  if (data_.find(frame_id) == data_.end()) {
+  auto &frame = frames_[frame_id];
+  if (frame.history_.empty()) {
     return;
   }
 
-  BUSTUB_ASSERT(data_[frame_id].evictable_, "Remove failed: Removal called on a non-evictable frame");
-
-  if (data_[frame_id].use_count_ < k_) {
-    history_list_.erase(data_[frame_id].pos_);
-  } else {
-    cache_list_.erase(data_[frame_id].pos_);
-  }
+  BUSTUB_ASSERT(frame.evictable_, "Remove failed: Removal called on a non-evictable frame");
 
-  data_.erase(frame_id);
+  evict_index_.erase(GetEvictKey(frame_id));
+  frame.history_.clear();
+  frame.evictable_ = false;
   curr_size_--;
 }
 
 auto LRUKReplacer::Size() -> size_t { return curr_size_; }
 
+auto LRUKReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  for (auto it = evict_index_.begin(); it != evict_index_.end() && candidates.size() < max_frames; ++it) {
+    candidates.push_back(std::get<2>(*it));
+  }
+  return candidates;
+}
+
 }  // namespace bustub
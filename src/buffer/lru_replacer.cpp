@@ -12,18 +12,81 @@
 
 #include "buffer/lru_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages) {}
+LRUReplacer::LRUReplacer(size_t num_pages) : replacer_size_(num_pages), frames_(num_pages) {}
 
 LRUReplacer::~LRUReplacer() = default;
 
-auto LRUReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto LRUReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (lru_.empty()) {
+    return false;
+  }
+  *frame_id = lru_.begin()->second;
+  lru_.erase(lru_.begin());
+  frames_[*frame_id] = FrameInfo{};
+  return true;
+}
+
+void LRUReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
+
+  auto &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    lru_.erase({frame.last_access_, frame_id});
+  }
+  frame.tracked_ = true;
+  frame.last_access_ = current_timestamp_++;
+  if (frame.evictable_) {
+    lru_.emplace(frame.last_access_, frame_id);
+  }
+}
+
+void LRUReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
+
+  auto &frame = frames_[frame_id];
+  if (!frame.tracked_ || frame.evictable_ == set_evictable) {
+    return;
+  }
+  if (set_evictable) {
+    lru_.emplace(frame.last_access_, frame_id);
+  } else {
+    lru_.erase({frame.last_access_, frame_id});
+  }
+  frame.evictable_ = set_evictable;
+}
+
+void LRUReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
 
-void LRUReplacer::Pin(frame_id_t frame_id) {}
+  auto &frame = frames_[frame_id];
+  if (!frame.tracked_) {
+    return;
+  }
+  BUSTUB_ASSERT(frame.evictable_, "Remove failed: Removal called on a non-evictable frame");
+  lru_.erase({frame.last_access_, frame_id});
+  frame = FrameInfo{};
+}
 
-void LRUReplacer::Unpin(frame_id_t frame_id) {}
+auto LRUReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return lru_.size();
+}
 
-auto LRUReplacer::Size() -> size_t { return 0; }
+auto LRUReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  for (auto it = lru_.begin(); it != lru_.end() && candidates.size() < max_frames; ++it) {
+    candidates.push_back(it->second);
+  }
+  return candidates;
+}
 
 }  // namespace bustub
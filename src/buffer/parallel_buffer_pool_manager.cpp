@@ -0,0 +1,206 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     size_t replacer_k, LogManager *log_manager,
+                                                     ReplacerType replacer_type, bool use_huge_pages)
+    : pool_size_(pool_size), disk_manager_(disk_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel BPM needs at least one instance");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        pool_size, static_cast<uint32_t>(num_instances), static_cast<uint32_t>(i), disk_manager, replacer_k,
+        log_manager, replacer_type, use_huge_pages));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() = default;
+
+auto ParallelBufferPoolManager::GetPoolSize() -> size_t { return pool_size_ * instances_.size(); }
+
+auto ParallelBufferPoolManager::GetNumFreeFrames() -> size_t {
+  size_t num_free_frames = 0;
+  for (auto &instance : instances_) {
+    num_free_frames += instance->GetNumFreeFrames();
+  }
+  return num_free_frames;
+}
+
+auto ParallelBufferPoolManager::GetStats() -> std::vector<BufferPoolStatsSnapshot> {
+  std::vector<BufferPoolStatsSnapshot> stats;
+  stats.reserve(instances_.size());
+  for (auto &instance : instances_) {
+    auto instance_stats = instance->GetStats();
+    stats.insert(stats.end(), instance_stats.begin(), instance_stats.end());
+  }
+  return stats;
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance * {
+  // a negative id has no owner: the modulo of a negative number would index out of range
+  if (page_id < 0) {
+    return nullptr;
+  }
+  return instances_[page_id % instances_.size()].get();
+}
+
+void ParallelBufferPoolManager::RunBackgroundWriter(const BackgroundWriterOptions &options) {
+  for (auto &instance : instances_) {
+    instance->RunBackgroundWriter(options);
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundWriter() {
+  for (auto &instance : instances_) {
+    instance->StopBackgroundWriter();
+  }
+}
+
+auto ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) -> Page * {
+  BufferPoolManagerInstance *instance = GetBufferPoolManager(page_id);
+  if (instance == nullptr) {
+    return nullptr;
+  }
+  return instance->FetchPage(page_id);
+}
+
+auto ParallelBufferPoolManager::FetchPgWithStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  BufferPoolManagerInstance *instance = GetBufferPoolManager(page_id);
+  if (instance == nullptr) {
+    return nullptr;
+  }
+  return instance->FetchPageWithStrategy(page_id, strategy);
+}
+
+auto ParallelBufferPoolManager::FetchPgReadOnlyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  BufferPoolManagerInstance *instance = GetBufferPoolManager(page_id);
+  if (instance == nullptr) {
+    return nullptr;
+  }
+  return instance->FetchPageReadOnly(page_id, strategy);
+}
+
+void ParallelBufferPoolManager::AdviseAccessPatternImp(page_id_t first_page_id, size_t num_pages,
+                                                       AccessPattern pattern) {
+  instances_[0]->AdviseAccessPattern(first_page_id, num_pages, pattern);
+}
+
+auto ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  BufferPoolManagerInstance *instance = GetBufferPoolManager(page_id);
+  if (instance == nullptr) {
+    return false;
+  }
+  return instance->UnpinPage(page_id, is_dirty);
+}
+
+auto ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) -> bool {
+  BufferPoolManagerInstance *instance = GetBufferPoolManager(page_id);
+  if (instance == nullptr) {
+    return false;
+  }
+  return instance->FlushPage(page_id);
+}
+
+auto ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) -> Page * {
+  // each call starts from a different shard, so allocations (and the latches they take) spread across all instances
+  const size_t num_instances = instances_.size();
+  const size_t start = next_instance_.fetch_add(1, std::memory_order_relaxed) % num_instances;
+  for (size_t i = 0; i < num_instances; i++) {
+    Page *page = instances_[(start + i) % num_instances]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::NewPgNearImp(page_id_t *page_id, page_id_t hint) -> Page * {
+  if (hint == INVALID_PAGE_ID) {
+    return NewPgImp(page_id);
+  }
+  // only the hint's own instance can hand out pages right next to it
+  const size_t num_instances = instances_.size();
+  const size_t start = hint % num_instances;
+  for (size_t i = 0; i < num_instances; i++) {
+    Page *page = instances_[(start + i) % num_instances]->NewPageNear(page_id, hint);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::NewPgInExtentImp(page_id_t *page_id, ExtentAllocator *extents) -> Page * {
+  // the instance of the next page keeps the extent filling up in order; before the first extent any instance will do
+  const size_t num_instances = instances_.size();
+  const page_id_t next_page_id = extents->GetNextPage();
+  const size_t start = next_page_id == INVALID_PAGE_ID
+                           ? next_instance_.fetch_add(1, std::memory_order_relaxed) % num_instances
+                           : next_page_id % num_instances;
+  for (size_t i = 0; i < num_instances; i++) {
+    Page *page = instances_[(start + i) % num_instances]->NewPageInExtent(page_id, extents);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool {
+  BufferPoolManagerInstance *instance = GetBufferPoolManager(page_id);
+  // like an instance, there is nothing to delete for an invalid id
+  if (instance == nullptr) {
+    return true;
+  }
+  return instance->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPgsImp() {
+  // adjacent pages belong to different instances, so the dirty pages of all instances are sorted together
+  std::vector<std::pair<page_id_t, frame_id_t>> dirty_pages;
+  for (auto &instance : instances_) {
+    auto instance_pages = instance->CollectDirtyPages();
+    dirty_pages.insert(dirty_pages.end(), instance_pages.begin(), instance_pages.end());
+  }
+  std::sort(dirty_pages.begin(), dirty_pages.end());
+
+  const size_t num_instances = instances_.size();
+  const size_t chunk_size = FLUSH_CHUNK_SIZE * num_instances;
+  for (size_t first = 0; first < dirty_pages.size(); first += chunk_size) {
+    std::vector<std::vector<std::pair<page_id_t, frame_id_t>>> chunks(num_instances);
+    for (size_t i = first; i < std::min(first + chunk_size, dirty_pages.size()); i++) {
+      chunks[dirty_pages[i].first % num_instances].push_back(dirty_pages[i]);
+    }
+    std::vector<std::pair<page_id_t, const char *>> batch;
+    std::vector<std::vector<std::pair<frame_id_t, uint64_t>>> frames;
+    frames.reserve(num_instances);
+    for (size_t i = 0; i < num_instances; i++) {
+      frames.push_back(instances_[i]->BeginFlush(chunks[i], &batch));
+    }
+    const bool succeeded = disk_manager_->WritePageBatch(&batch);
+    for (size_t i = 0; i < num_instances; i++) {
+      instances_[i]->EndFlush(frames[i], succeeded);
+    }
+  }
+}
+
+}  // namespace bustub
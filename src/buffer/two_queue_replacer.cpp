@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : replacer_size_(num_frames),
+      max_a1in_size_(std::max<size_t>(num_frames / 4, 1)),
+      max_a1out_size_(std::max<size_t>(num_frames / 2, 1)),
+      frames_(num_frames) {}
+
+auto TwoQueueReplacer::EvictableQueue(const FrameInfo &frame) -> std::set<std::pair<size_t, frame_id_t>> & {
+  return frame.queue_ == Queue::A1IN ? a1in_ : am_;
+}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+
+  // reclaim from A1in while it is over Kin, otherwise from Am, falling back to the other queue when the preferred
+  // one only holds pinned frames
+  bool from_a1in;
+  if (!a1in_.empty() && (a1in_size_ > max_a1in_size_ || am_.empty())) {
+    from_a1in = true;
+  } else if (!am_.empty()) {
+    from_a1in = false;
+  } else {
+    return false;
+  }
+
+  auto &evictable = from_a1in ? a1in_ : am_;
+  *frame_id = evictable.begin()->second;
+  evictable.erase(evictable.begin());
+
+  auto &frame = frames_[*frame_id];
+  if (from_a1in) {
+    a1in_size_--;
+    a1out_.push_back(frame.page_id_);
+    a1out_index_[frame.page_id_] = std::prev(a1out_.end());
+    if (a1out_.size() > max_a1out_size_) {
+      a1out_index_.erase(a1out_.front());
+      a1out_.pop_front();
+    }
+  }
+  frame = FrameInfo{};
+  return true;
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
+
+  auto &frame = frames_[frame_id];
+
+  // cache hit: Am is LRU ordered, re-references in A1in are ignored
+  if (frame.queue_ == Queue::AM) {
+    if (frame.evictable_) {
+      am_.erase({frame.timestamp_, frame_id});
+    }
+    frame.timestamp_ = current_timestamp_++;
+    if (frame.evictable_) {
+      am_.emplace(frame.timestamp_, frame_id);
+    }
+    return;
+  }
+  if (frame.queue_ == Queue::A1IN) {
+    return;
+  }
+
+  // cache miss: a page we evicted from A1in not long ago is hot
+  auto ghost = a1out_index_.find(page_id);
+  if (ghost != a1out_index_.end()) {
+    a1out_.erase(ghost->second);
+    a1out_index_.erase(ghost);
+    frame.queue_ = Queue::AM;
+  } else {
+    frame.queue_ = Queue::A1IN;
+    a1in_size_++;
+  }
+  frame.page_id_ = page_id;
+  frame.timestamp_ = current_timestamp_++;
+}
+
+void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
+
+  auto &frame = frames_[frame_id];
+  if (frame.queue_ == Queue::NONE || frame.evictable_ == set_evictable) {
+    return;
+  }
+  if (set_evictable) {
+    EvictableQueue(frame).emplace(frame.timestamp_, frame_id);
+  } else {
+    EvictableQueue(frame).erase({frame.timestamp_, frame_id});
+  }
+  frame.evictable_ = set_evictable;
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id < static_cast<frame_id_t>(replacer_size_), "frame id is invalid");
+
+  auto &frame = frames_[frame_id];
+  if (frame.queue_ == Queue::NONE) {
+    return;
+  }
+  BUSTUB_ASSERT(frame.evictable_, "Remove failed: Removal called on a non-evictable frame");
+
+  EvictableQueue(frame).erase({frame.timestamp_, frame_id});
+  if (frame.queue_ == Queue::A1IN) {
+    a1in_size_--;
+  }
+  frame = FrameInfo{};
+}
+
+auto TwoQueueReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return a1in_.size() + am_.size();
+}
+
+auto TwoQueueReplacer::EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // A1in is reclaimed first while it is over Kin, after that Am
+  bool a1in_first = !a1in_.empty() && (a1in_size_ > max_a1in_size_ || am_.empty());
+  std::vector<frame_id_t> candidates;
+  for (const auto *queue : {a1in_first ? &a1in_ : &am_, a1in_first ? &am_ : &a1in_}) {
+    for (auto it = queue->begin(); it != queue->end() && candidates.size() < max_frames; ++it) {
+      candidates.push_back(it->second);
+    }
+  }
+  return candidates;
+}
+
+}  // namespace bustub
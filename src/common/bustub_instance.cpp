@@ -33,6 +33,7 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_posix.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -45,7 +46,7 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   enable_logging = false;
 
   // Storage related.
-  disk_manager_ = new DiskManager(db_file_name);
+  disk_manager_ = new PosixDiskManager(db_file_name);
 
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
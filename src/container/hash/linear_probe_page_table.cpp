@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_page_table.cpp
+//
+// Identification: src/container/hash/linear_probe_page_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/linear_probe_page_table.h"
+
+namespace bustub {
+
+LinearProbePageTable::LinearProbePageTable(size_t max_size) {
+  // keep the load factor at or below 1/2, and use at least one full cache line
+  capacity_bits_ = 3;
+  while ((static_cast<size_t>(1) << capacity_bits_) < 2 * max_size) {
+    capacity_bits_++;
+  }
+  capacity_ = static_cast<size_t>(1) << capacity_bits_;
+  blocks_ = std::make_unique<SlotBlock[]>(capacity_ / SLOTS_PER_BLOCK);
+  for (size_t i = 0; i < capacity_; i++) {
+    Slot(i).store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+auto LinearProbePageTable::Probe(uint32_t key, size_t *index) -> bool {
+  *index = HomeSlotOfKey(key);
+  if (key == EMPTY_KEY) {
+    // INVALID_PAGE_ID is never stored, it marks the empty slots
+    return false;
+  }
+  for (size_t probes = 0; probes < capacity_; probes++) {
+    auto slot_key = SlotKey(Slot(*index).load(std::memory_order_acquire));
+    if (slot_key == key) {
+      return true;
+    }
+    if (slot_key == EMPTY_KEY) {
+      return false;
+    }
+    *index = (*index + 1) & (capacity_ - 1);
+  }
+  return false;
+}
+
+auto LinearProbePageTable::Find(const page_id_t &page_id, frame_id_t &frame_id) -> bool {
+  auto key = static_cast<uint32_t>(page_id);
+  while (true) {
+    auto sequence = shift_sequence_.load(std::memory_order_acquire);
+    if (sequence % 2 == 1) {
+      continue;
+    }
+    size_t index;
+    if (Probe(key, &index)) {
+      // an entry that was found is valid even if it was being moved: it has the same frame in both slots
+      auto slot = Slot(index).load(std::memory_order_acquire);
+      if (SlotKey(slot) == key) {
+        frame_id = SlotValue(slot);
+        return true;
+      }
+    }
+    // a miss only counts if no entry was shifted past the probe meanwhile
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (shift_sequence_.load(std::memory_order_relaxed) == sequence) {
+      return false;
+    }
+  }
+}
+
+auto LinearProbePageTable::GetProbeLength(const page_id_t &page_id) -> size_t {
+  std::scoped_lock<std::mutex> lock(writer_latch_);
+  size_t index;
+  Probe(static_cast<uint32_t>(page_id), &index);
+  return ((index - HomeSlot(page_id)) & (capacity_ - 1)) + 1;
+}
+
+auto LinearProbePageTable::Remove(const page_id_t &page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(writer_latch_);
+  size_t hole;
+  if (!Probe(static_cast<uint32_t>(page_id), &hole)) {
+    return false;
+  }
+
+  auto sequence = shift_sequence_.load(std::memory_order_relaxed);
+  shift_sequence_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  // move every later entry of the chain that may live in the hole into it, until the chain ends
+  for (auto index = (hole + 1) & (capacity_ - 1);; index = (index + 1) & (capacity_ - 1)) {
+    auto slot = Slot(index).load(std::memory_order_relaxed);
+    if (SlotKey(slot) == EMPTY_KEY) {
+      break;
+    }
+    // an entry stays if its home slot lies cyclically in (hole, index], probing for it never passes the hole
+    auto home = HomeSlotOfKey(SlotKey(slot));
+    if (((home - hole - 1) & (capacity_ - 1)) < ((index - hole) & (capacity_ - 1))) {
+      continue;
+    }
+    Slot(hole).store(slot, std::memory_order_release);
+    hole = index;
+  }
+  Slot(hole).store(EMPTY_SLOT, std::memory_order_release);
+  shift_sequence_.store(sequence + 2, std::memory_order_release);
+  return true;
+}
+
+void LinearProbePageTable::Insert(const page_id_t &page_id, const frame_id_t &frame_id) {
+  std::scoped_lock<std::mutex> lock(writer_latch_);
+  size_t index;
+  // either the slot of the page, or the empty slot at the end of its chain
+  bool found = Probe(static_cast<uint32_t>(page_id), &index);
+  BUSTUB_ASSERT(found || SlotKey(Slot(index).load(std::memory_order_relaxed)) == EMPTY_KEY, "page table is full");
+  Slot(index).store(MakeSlot(page_id, frame_id), std::memory_order_release);
+}
+
+}  // namespace bustub
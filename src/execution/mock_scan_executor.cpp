@@ -41,7 +41,9 @@ const char *mock_table_list[] = {"__mock_table_1", "__mock_table_2", "__mock_tab
                                  // For leaderboard Q2
                                  "__mock_t4_1m", "__mock_t5_1m", "__mock_t6_1m",
                                  // For leaderboard Q3
-                                 "__mock_t7", "__mock_t8", nullptr};
+                                 "__mock_t7", "__mock_t8",
+                                 // System tables, filled from the running instance, see GetSystemTableRows()
+                                 "__buffer_pool_stats", "__buffer_pool_fetch_latency", nullptr};
 
 static const int GRAPH_NODE_CNT = 10;
 
@@ -96,6 +98,19 @@ auto GetMockTableSchemaOf(const std::string &table) -> Schema {
     return Schema{std::vector{Column{"v4", TypeId::INTEGER}}};
   }
 
+  if (table == "__buffer_pool_stats") {
+    return Schema{std::vector{Column{"instance", TypeId::INTEGER}, Column{"hits", TypeId::BIGINT},
+                              Column{"misses", TypeId::BIGINT}, Column{"hit_ratio", TypeId::DECIMAL},
+                              Column{"evictions", TypeId::BIGINT}, Column{"writebacks", TypeId::BIGINT},
+                              Column{"flushes", TypeId::BIGINT}, Column{"pin_failures", TypeId::BIGINT},
+                              Column{"fetch_p50_ns", TypeId::BIGINT}, Column{"fetch_p99_ns", TypeId::BIGINT}}};
+  }
+
+  if (table == "__buffer_pool_fetch_latency") {
+    return Schema{std::vector{Column{"instance", TypeId::INTEGER}, Column{"below_ns", TypeId::BIGINT},
+                              Column{"fetches", TypeId::BIGINT}}};
+  }
+
   throw bustub::Exception(fmt::format("mock table {} not found", table));
 }
 
@@ -379,8 +394,53 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
   };
 }
 
+auto IsSystemTable(const std::string &table) -> bool { return StringUtil::StartsWith(table, "__buffer_pool"); }
+
+/** One row per buffer pool manager instance, or per non-empty fetch latency bucket of an instance. */
+auto GetSystemTableRows(ExecutorContext *exec_ctx, const MockScanPlanNode *plan) -> std::vector<Tuple> {
+  std::vector<Tuple> rows;
+  auto *bpm = exec_ctx->GetBufferPoolManager();
+  if (bpm == nullptr) {
+    return rows;
+  }
+  const auto &table = plan->GetTable();
+  auto count = [](uint64_t n) { return ValueFactory::GetBigIntValue(static_cast<int64_t>(n)); };
+  for (const auto &stats : bpm->GetStats()) {
+    auto instance = ValueFactory::GetIntegerValue(static_cast<int32_t>(stats.instance_index_));
+    if (table == "__buffer_pool_stats") {
+      std::vector<Value> values{instance,
+                                count(stats.hits_),
+                                count(stats.misses_),
+                                ValueFactory::GetDecimalValue(stats.GetHitRatio()),
+                                count(stats.evictions_),
+                                count(stats.writebacks_),
+                                count(stats.flushes_),
+                                count(stats.pin_failures_),
+                                count(stats.GetFetchLatencyPercentile(0.5)),
+                                count(stats.GetFetchLatencyPercentile(0.99))};
+      rows.emplace_back(values, &plan->OutputSchema());
+      continue;
+    }
+    for (size_t i = 0; i < BufferPoolStatsSnapshot::NUM_LATENCY_BUCKETS; i++) {
+      if (stats.fetch_latency_[i] == 0) {
+        continue;
+      }
+      std::vector<Value> values{instance,
+                                count(BufferPoolStatsSnapshot::GetBucketUpperBound(i)),
+                                count(stats.fetch_latency_[i])};
+      rows.emplace_back(values, &plan->OutputSchema());
+    }
+  }
+  return rows;
+}
+
 MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan)
     : AbstractExecutor{exec_ctx}, plan_{plan}, func_(GetFunctionOf(plan)), size_(GetSizeOf(plan)) {
+  if (IsSystemTable(plan->GetTable())) {
+    rows_ = GetSystemTableRows(exec_ctx, plan);
+    size_ = rows_.size();
+    func_ = [this](size_t cursor) { return rows_[cursor]; };
+  }
   if (GetShuffled(plan)) {
     for (size_t i = 0; i < size_; i++) {
       shuffled_idx_.push_back(i);
@@ -19,7 +19,16 @@ SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNod
   this->tableinfo_ = exec_ctx_->GetCatalog()->GetTable(plan->table_oid_);
 }
 
-void SeqScanExecutor::Init() { this->table_iter_ = tableinfo_->table_->Begin(exec_ctx_->GetTransaction()); }
+void SeqScanExecutor::Init() {
+  // a small table is cached like any other pages, only a large one is read through a ring so it does not flush the pool
+  auto num_pages = tableinfo_->table_->GetNumPages();
+  if (num_pages > exec_ctx_->GetBufferPoolManager()->GetPoolSize() / BufferAccessStrategy::BULK_READ_POOL_FRACTION) {
+    this->strategy_ = std::make_shared<BufferAccessStrategy>();
+  } else {
+    this->strategy_ = nullptr;
+  }
+  this->table_iter_ = tableinfo_->table_->Begin(exec_ctx_->GetTransaction(), strategy_);
+}
 
 auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   do {
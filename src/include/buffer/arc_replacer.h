@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ArcReplacer implements the Adaptive Replacement Cache policy (Megiddo & Modha, FAST '03).
+ *
+ * Resident frames are split between T1 (pages seen once since they were loaded) and T2 (pages seen at least twice).
+ * Pages evicted from T1 and T2 are remembered in the ghost lists B1 and B2. A miss on a page in B1 means T1 was too
+ * small and grows the target size p of T1; a miss on a page in B2 shrinks it. Eviction takes the LRU evictable frame
+ * of T1 while T1 is larger than p, and of T2 otherwise, so a large scan only ever churns through T1 and cannot flush
+ * the frequently used pages of T2.
+ */
+class ArcReplacer : public Replacer {
+ public:
+  /**
+   * @brief Create a new ArcReplacer.
+   * @param num_frames the maximum number of frames the ArcReplacer will be required to store
+   */
+  explicit ArcReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ArcReplacer);
+
+  ~ArcReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+ private:
+  enum class ArcList { NONE, T1, T2 };
+
+  struct FrameInfo {
+    ArcList list_{ArcList::NONE};
+    bool evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    size_t last_access_{0};
+  };
+
+  /** @return the evictable frames of the list the frame is resident in */
+  auto EvictableList(const FrameInfo &frame) -> std::set<std::pair<size_t, frame_id_t>> &;
+
+  /** Drop the LRU ghosts until |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c. */
+  void TrimGhosts();
+
+  /** c, the number of frames. */
+  size_t replacer_size_;
+  /** p, the target size of T1. */
+  size_t target_t1_size_{0};
+  /** Number of frames resident in T1 and T2, pinned ones included. */
+  size_t t1_size_{0};
+  size_t t2_size_{0};
+  size_t current_timestamp_{0};
+
+  /** Per-frame state, indexed by frame id. */
+  std::vector<FrameInfo> frames_;
+  /** Evictable frames of T1 and T2 ordered by their last access, least recent first. */
+  std::set<std::pair<size_t, frame_id_t>> t1_;
+  std::set<std::pair<size_t, frame_id_t>> t2_;
+  /** Ghost lists of evicted page ids, least recent first. */
+  std::list<page_id_t> b1_;
+  std::list<page_id_t> b2_;
+  /** Position of every ghost page, and whether it is in B2. */
+  std::unordered_map<page_id_t, std::pair<bool, std::list<page_id_t>::iterator>> ghosts_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
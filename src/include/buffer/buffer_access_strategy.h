@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * BufferAccessStrategy gives a bulk operation, e.g. a large sequential scan, a small private ring of frames.
+ *
+ * Pages fetched through the strategy that miss the buffer pool are loaded into the frame of the page the ring loaded
+ * ring_size misses ago, if that page is still resident and unpinned. A scan then keeps recycling its own frames
+ * instead of evicting the shared working set. Pages that hit the buffer pool are not added to the ring, and until the
+ * ring is full (or when its oldest page was evicted or pinned meanwhile) a miss takes a victim from the replacer as
+ * usual.
+ *
+ * Every BufferPoolManagerInstance gets a ring of its own, because frames cannot move between instances. The rings are
+ * latched, so a strategy can be shared by a scan and its read-ahead.
+ */
+class BufferAccessStrategy {
+ public:
+  /** Default ring size, i.e. the number of frames a bulk read may hold in one buffer pool instance. */
+  static constexpr size_t DEFAULT_RING_SIZE = 32;
+  /** Like in PostgreSQL, only a scan of more than 1/BULK_READ_POOL_FRACTION of the buffer pool is a bulk read. */
+  static constexpr size_t BULK_READ_POOL_FRACTION = 4;
+
+  /**
+   * @brief Create a new BufferAccessStrategy.
+   * @param ring_size the number of frames of the ring
+   */
+  explicit BufferAccessStrategy(size_t ring_size = DEFAULT_RING_SIZE);
+
+  DISALLOW_COPY_AND_MOVE(BufferAccessStrategy);
+
+  /** @return the number of frames of the ring */
+  auto GetRingSize() const -> size_t { return ring_size_; }
+
+  /**
+   * @brief Return the page whose frame the next miss in the given buffer pool instance should recycle.
+   * @param instance_index the index of the buffer pool instance
+   * @return the page loaded ring_size misses ago, or INVALID_PAGE_ID if the ring is not full yet
+   */
+  auto GetRecyclePage(uint32_t instance_index) -> page_id_t;
+
+  /**
+   * @brief Record that a miss loaded the given page, replacing the page returned by GetRecyclePage().
+   * @param instance_index the index of the buffer pool instance
+   * @param page_id the page that was loaded
+   */
+  void RecordLoad(uint32_t instance_index, page_id_t page_id);
+
+ private:
+  struct Ring {
+    /** Pages loaded by the ring, indexed by slot. */
+    std::vector<page_id_t> pages_;
+    /** The slot the next miss replaces. */
+    size_t next_slot_{0};
+  };
+
+  size_t ring_size_;
+  std::unordered_map<uint32_t, Ring> rings_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -15,10 +15,14 @@
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_stats.h"
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/extent_allocator.h"
 #include "storage/page/page.h"
 
 namespace bustub {
@@ -46,6 +50,37 @@ class BufferPoolManager {
     return result;
   }
 
+  /**
+   * Fetch a page for a bulk read. Misses recycle the frames of the strategy's ring instead of evicting shared pages.
+   * @param page_id id of page to be fetched
+   * @param strategy the ring of the bulk read, nullptr to fetch as usual
+   * @return the requested page, or nullptr if it cannot be fetched
+   */
+  auto FetchPageWithStrategy(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+    return FetchPgWithStrategyImp(page_id, strategy);
+  }
+
+  /**
+   * Fetch a page that the caller only reads. Such a page may be used in place in a mapped database file, so the caller
+   * must not modify it and must unpin it with is_dirty false.
+   * @param page_id id of page to be fetched
+   * @param strategy the ring of a bulk read, nullptr to fetch as usual
+   * @return the requested page, or nullptr if it cannot be fetched
+   */
+  auto FetchPageReadOnly(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) -> Page * {
+    return FetchPgReadOnlyImp(page_id, strategy);
+  }
+
+  /**
+   * Hint how a range of pages is going to be accessed by the caller, see DiskManager::AdviseAccessPattern().
+   * @param first_page_id id of the first page of the range
+   * @param num_pages number of pages in the range
+   * @param pattern the expected access pattern
+   */
+  void AdviseAccessPattern(page_id_t first_page_id, size_t num_pages, AccessPattern pattern) {
+    AdviseAccessPatternImp(first_page_id, num_pages, pattern);
+  }
+
   /** Grading function. Do not modify! */
   auto UnpinPage(page_id_t page_id, bool is_dirty, bufferpool_callback_fn callback = nullptr) -> bool {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
@@ -70,6 +105,24 @@ class BufferPoolManager {
     return result;
   }
 
+  /**
+   * Create a new page that is physically close to another page, e.g. the sibling of a split B+ tree node.
+   * @param[out] page_id id of created page
+   * @param hint the page to stay close to, INVALID_PAGE_ID for no preference
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPageNear(page_id_t *page_id, page_id_t hint) -> Page * { return NewPgNearImp(page_id, hint); }
+
+  /**
+   * Create a new page in the extents of a table heap or index, so that the pages of the object stay contiguous.
+   * @param[out] page_id id of created page
+   * @param extents the extents of the object
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPageInExtent(page_id_t *page_id, ExtentAllocator *extents) -> Page * {
+    return NewPgInExtentImp(page_id, extents);
+  }
+
   /** Grading function. Do not modify! */
   auto DeletePage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) -> bool {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
@@ -88,6 +141,12 @@ class BufferPoolManager {
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
+  /** @return the number of frames that could take another page right now, because they are free or evictable */
+  virtual auto GetNumFreeFrames() -> size_t { return GetPoolSize(); }
+
+  /** @return the statistics of every instance of the buffer pool, empty if it keeps none */
+  virtual auto GetStats() -> std::vector<BufferPoolStatsSnapshot> { return {}; }
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -109,6 +168,35 @@ class BufferPoolManager {
    */
   virtual auto FetchPgImp(page_id_t page_id) -> Page * = 0;
 
+  /**
+   * Fetch the requested page from the buffer pool, loading it into the strategy's ring on a miss. Buffer pools
+   * without ring support fetch as usual.
+   * @param page_id id of page to be fetched
+   * @param strategy the ring of the bulk read, may be nullptr
+   * @return the requested page
+   */
+  virtual auto FetchPgWithStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+    return FetchPgImp(page_id);
+  }
+
+  /**
+   * Fetch the requested page for reading only. Buffer pools that never use mapped pages fetch as usual.
+   * @param page_id id of page to be fetched
+   * @param strategy the ring of the bulk read, may be nullptr
+   * @return the requested page
+   */
+  virtual auto FetchPgReadOnlyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+    return FetchPgWithStrategyImp(page_id, strategy);
+  }
+
+  /**
+   * Pass the access pattern hint on to the disk manager. Does nothing by default.
+   * @param first_page_id id of the first page of the range
+   * @param num_pages number of pages in the range
+   * @param pattern the expected access pattern
+   */
+  virtual void AdviseAccessPatternImp(page_id_t first_page_id, size_t num_pages, AccessPattern pattern) {}
+
   /**
    * Unpin the target page from the buffer pool.
    * @param page_id id of page to be unpinned
@@ -131,6 +219,22 @@ class BufferPoolManager {
    */
   virtual auto NewPgImp(page_id_t *page_id) -> Page * = 0;
 
+  /**
+   * Creates a new page in the buffer pool, close to the hint. Buffer pools without placement ignore the hint.
+   * @param[out] page_id id of created page
+   * @param hint the page to stay close to, INVALID_PAGE_ID for no preference
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPgNearImp(page_id_t *page_id, page_id_t hint) -> Page * { return NewPgImp(page_id); }
+
+  /**
+   * Creates a new page in the buffer pool, taken from the given extents. Buffer pools without placement ignore them.
+   * @param[out] page_id id of created page
+   * @param extents the extents of the table heap or index the page belongs to
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPgInExtentImp(page_id_t *page_id, ExtentAllocator *extents) -> Page * { return NewPgImp(page_id); }
+
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
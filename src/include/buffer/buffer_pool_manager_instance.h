@@ -12,20 +12,43 @@
 
 #pragma once
 
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
 #include <list>
-#include <mutex>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_stats.h"
 #include "buffer/lru_k_replacer.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
-#include "container/hash/extendible_hash_table.h"
+#include "container/hash/linear_probe_page_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
 
 namespace bustub {
 
+/** Disk I/O that is in flight on a frame. The BPM latch is not held while the I/O runs. */
+enum class FrameIoState { NONE, WRITING, READING };
+
+/** Settings of the background writer, see BufferPoolManagerInstance::RunBackgroundWriter(). */
+struct BackgroundWriterOptions {
+  /** How long the writer sleeps between two rounds. */
+  std::chrono::milliseconds interval_{std::chrono::milliseconds(200)};
+  /** The maximum number of pages written in one round. Together with interval_ this bounds the write rate. */
+  size_t max_pages_per_round_{100};
+  /** A round writes nothing unless more than this fraction of the frames is dirty. */
+  double dirty_ratio_threshold_{0.0};
+  /** How many of the next victims of the replacer a round looks at. */
+  size_t lookahead_{200};
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
@@ -37,9 +60,28 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy
+   * @param use_huge_pages back the frames with huge pages if the system has them
    */
   BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRUK,
+                            bool use_huge_pages = false);
+
+  /**
+   * @brief Creates a new BufferPoolManagerInstance that is one shard of a ParallelBufferPoolManager.
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of BPIs in the parallel BPM
+   * @param instance_index index of this BPI in the parallel BPM
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy
+   * @param use_huge_pages back the frames with huge pages if the system has them
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRUK,
+                            bool use_huge_pages = false);
 
   /**
    * @brief Destroy an existing BufferPoolManagerInstance.
@@ -49,9 +91,51 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t override { return pool_size_; }
 
+  /** @brief Return the number of frames on the free list or in the replacer. */
+  auto GetNumFreeFrames() -> size_t override;
+
+  /** @brief Return the statistics of this instance. */
+  auto GetStats() -> std::vector<BufferPoolStatsSnapshot> override { return {stats_.Snapshot(instance_index_)}; }
+
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
+  /**
+   * @brief Start the background writer. It periodically writes back dirty, unpinned pages that the replacer is about
+   * to evict, so that misses rarely have to write back a victim themselves. Does nothing if it is already running.
+   * @param options how often and how much the writer writes
+   */
+  void RunBackgroundWriter(const BackgroundWriterOptions &options);
+
+  /** @brief Stop the background writer and wait for it to exit. Does nothing if it is not running. */
+  void StopBackgroundWriter();
+
+  /**
+   * @brief List the dirty pages of the pool, the first step of FlushAllPages().
+   * @return the ids of the dirty pages and their frames, in frame order
+   */
+  auto CollectDirtyPages() -> std::vector<std::pair<page_id_t, frame_id_t>>;
+
+  /**
+   * @brief First half of a batched flush of a chunk of the dirty pages: mark the pages that are still dirty in their
+   * frames as being written, and add them to the batch. Until EndFlush(), fetchers of these pages wait and the frames
+   * cannot be evicted, so FlushAllPages() goes through the dirty pages chunk by chunk, in page id order.
+   * @param pages the chunk, ids of dirty pages with their frames as returned by CollectDirtyPages()
+   * @param[out] batch the ids and data of the pages to write, see DiskManager::WritePageBatch()
+   * @return the frames of the pages in the batch, with the number of times each page was dirtied so far
+   */
+  auto BeginFlush(const std::vector<std::pair<page_id_t, frame_id_t>> &pages,
+                  std::vector<std::pair<page_id_t, const char *>> *batch)
+      -> std::vector<std::pair<frame_id_t, uint64_t>>;
+
+  /**
+   * @brief Second half of a batched flush, once the batch was written. The pages become clean only if the write
+   * succeeded, and only if they were not dirtied again while they were written.
+   * @param frames the frames returned by BeginFlush()
+   * @param succeeded true if the batch was written
+   */
+  void EndFlush(const std::vector<std::pair<frame_id_t, uint64_t>> &frames, bool succeeded);
+
  protected:
   /**
    * TODO(P1): Add implementation
@@ -72,6 +156,24 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto NewPgImp(page_id_t *page_id) -> Page * override;
 
+  /**
+   * @brief Create a new page like NewPgImp(), reusing the deallocated page of this instance closest to the hint if
+   * the disk manager has one. A reused page is dirty right away, so its old contents on disk get overwritten.
+   * @param[out] page_id id of created page
+   * @param hint the page to stay close to, INVALID_PAGE_ID for no preference
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgNearImp(page_id_t *page_id, page_id_t hint) -> Page * override;
+
+  /**
+   * @brief Create a new page like NewPgImp(), taking the next page of this instance from the extents. A page of a
+   * reused extent is dirty right away, like a reused page of NewPgNearImp().
+   * @param[out] page_id id of created page
+   * @param extents the extents of the table heap or index the page belongs to
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgInExtentImp(page_id_t *page_id, ExtentAllocator *extents) -> Page * override;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -90,6 +192,30 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto FetchPgImp(page_id_t page_id) -> Page * override;
 
+  /**
+   * @brief Fetch the requested page like FetchPgImp(). On a miss, the frame of the page the strategy's ring loaded
+   * ring_size misses ago is recycled if that page is still resident and unpinned; otherwise a frame is picked as usual.
+   * The loaded page takes its place in the ring.
+   *
+   * @param page_id id of page to be fetched
+   * @param strategy the ring of the bulk read, nullptr to fetch as usual
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPgWithStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * @brief Fetch the requested page like FetchPgWithStrategyImp(), but for reading only. If the disk manager maps the
+   * database file, a miss uses the mapped page in place instead of reading it into the frame.
+   *
+   * @param page_id id of page to be fetched
+   * @param strategy the ring of the bulk read, nullptr to fetch as usual
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPgReadOnlyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /** @brief Pass the access pattern hint on to the disk manager. */
+  void AdviseAccessPatternImp(page_id_t first_page_id, size_t num_pages, AccessPattern pattern) override;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -111,17 +237,18 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @brief Flush the target page to disk.
    *
    * Use the DiskManager::WritePage() method to flush a page to disk, REGARDLESS of the dirty flag.
-   * Unset the dirty flag of the page after flushing.
+   * Unset the dirty flag of the page after flushing. The latch is not held during the write.
    *
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
-   * @return false if the page could not be found in the page table, true otherwise
+   * @return false if the page could not be found in the page table or could not be written, true otherwise
    */
   auto FlushPgImp(page_id_t page_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
    *
-   * @brief Flush all the pages in the buffer pool to disk.
+   * @brief Flush all the dirty pages in the buffer pool to disk. The dirty pages of the whole pool are sorted by page
+   * id and written in chunks of that order, without holding the latch.
    */
   void FlushAllPgsImp() override;
 
@@ -141,44 +268,185 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   auto DeletePgImp(page_id_t page_id) -> bool override;
 
   /**
-   * @brief To make a new frame and assign it to buffer pool
+   * @brief Check in constant time whether a miss can be served. Every frame is either on the free list, pinned, or
+   * evictable in the replacer, so a frame is available iff the free list or the replacer is non-empty.
+   * Caller should acquire the latch before calling this function.
+   * @return false if all frames are pinned
+   */
+  auto HasReplaceableFrame() -> bool;
+
+  /**
+   * @brief Recycle the frame of the strategy's ring, or take a frame from the free list, or evict one from the
+   * replacer, and unmap its old page. Caller should acquire the latch before calling this function.
+   * @param[out] frame_id the picked frame
+   * @param[out] dirty_page_id the evicted page if it still has to be written back, INVALID_PAGE_ID otherwise
+   * @param strategy the ring of a bulk read, may be nullptr
+   * @return false if all frames are pinned
+   */
+  auto PickReplacementFrame(frame_id_t *frame_id, page_id_t *dirty_page_id, BufferAccessStrategy *strategy = nullptr)
+      -> bool;
+
+  /**
+   * @brief Fill a frame that was just picked, mapped to its new page and pinned. The latch is released while the
+   * evicted dirty page is written back and while the new page is read from disk, and is held again on return.
+   * Concurrent fetchers of either page wait on this frame's condition variable instead of on the latch.
+   * For read-only fetches of a mapped database file, the page points into the mapping instead of being read.
+   * If the write back fails, the evicted page is mapped to the frame again, still dirty, and the caller's pin is dropped.
+   * @param lock the caller's lock on latch_
+   * @param frame_id the frame to fill
+   * @param dirty_page_id the evicted page to write back first, or INVALID_PAGE_ID
+   * @param read_from_disk true to read the frame's page from disk, false to zero it (for new pages)
+   * @param read_only true if the page may be used in place in the mapped database file
+   * @return false if the evicted page could not be written back, the frame then does not hold the new page
+   */
+  auto LoadFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_id, page_id_t dirty_page_id,
+                 bool read_from_disk, bool read_only = false) -> bool;
+
+  /**
+   * @brief Write a frame's page to disk once no I/O is in flight on it. Caller should hold the latch, which is released
+   * during the write like in LoadFrame(). The page stays dirty if the write fails.
+   * @param lock the caller's lock on latch_
+   * @param frame_id the frame to flush
+   * @param page_id the page the frame held when the caller looked it up
+   * @return false if the frame no longer holds the page or the write failed
    */
-  auto PickReplacementFrame(frame_id_t *frame_id) -> bool;
+  auto FlushFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_id, page_id_t page_id) -> bool;
+
+  /**
+   * @brief Set the dirty flag of a frame's page and keep the count of dirty frames. Caller should hold the latch.
+   * @param frame_id the frame whose page was modified or written back
+   * @param is_dirty the new dirty flag
+   */
+  void SetDirty(frame_id_t frame_id, bool is_dirty);
+
+  /**
+   * @brief One round of the background writer: write back the dirty pages among the next victims of the replacer.
+   * Caller should hold the latch, which is released around every write.
+   * @param lock the caller's lock on latch_
+   * @param options the limits of the round
+   * @return the number of pages written
+   */
+  auto BackgroundWriterRound(std::unique_lock<std::mutex> *lock, const BackgroundWriterOptions &options) -> size_t;
 
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
-  /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
-  /** Bucket size for the extendible hash table */
-  const size_t bucket_size_ = 4;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
 
   /** Array of buffer pool pages. */
   Page *pages_;
+  /**
+   * The page data of all frames in one block, aligned to BUSTUB_PAGE_SIZE so that frames can take part in direct I/O.
+   * It is mmap()ed if huge pages were requested, allocated from the heap otherwise.
+   */
+  char *frames_;
+  /** Size of the frame block in bytes, rounded up to the huge page size if it is mmap()ed. */
+  size_t frames_size_;
+  bool frames_mapped_{false};
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
   /** Page table for keeping track of buffer pool pages. */
-  ExtendibleHashTable<page_id_t, frame_id_t> *page_table_;
+  LinearProbePageTable *page_table_;
   /** Replacer to find unpinned pages for replacement. */
-  LRUKReplacer *replacer_;
+  Replacer *replacer_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** In-flight I/O of each frame. */
+  std::vector<FrameIoState> io_state_;
+  /** Signalled whenever the in-flight I/O of the frame changes. */
+  std::unique_ptr<std::condition_variable[]> io_cv_;
+  /** Evicted pages whose writeback has not reached the disk yet, and the frame they are written from. */
+  std::unordered_map<page_id_t, frame_id_t> writeback_pages_;
+  /** Hits, misses, evictions, writes and fetch latencies of this instance. */
+  BufferPoolStats stats_;
+  /** Number of frames whose page is dirty. */
+  size_t num_dirty_frames_{0};
+  /** Number of times the page of each frame was dirtied, a flush compares it before it cleans the page. */
+  std::vector<uint64_t> dirty_counts_;
+  /** The background writer thread, if running. */
+  std::thread background_writer_;
+  bool background_writer_running_{false};
+  std::condition_variable background_writer_cv_;
+  /**
+   * This latch protects the page table, the replacer, the free list, the frame I/O states, the in-flight writebacks,
+   * the background writer state and the book-keeping fields (page id, pin count, dirty flag) of every page. It is
+   * never held across disk I/O done for a page miss.
+   */
   std::mutex latch_;
 
+  /** Size of a huge page, the frame block is mapped in multiples of it. */
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Point the page of a frame back at the frame's own data, in case it pointed at a mapped page.
+   * @param frame_id the frame
+   */
+  void UseFrameData(frame_id_t frame_id) { pages_[frame_id].data_ = frames_ + frame_id * BUSTUB_PAGE_SIZE; }
+
+  /**
+   * @param frame_id the frame
+   * @return true if the page of the frame is used in place in the mapped database file
+   */
+  auto IsFrameMapped(frame_id_t frame_id) -> bool {
+    return pages_[frame_id].data_ != frames_ + frame_id * BUSTUB_PAGE_SIZE;
+  }
+
+  /**
+   * @brief Allocate frames_ for pool_size_ frames.
+   * @param use_huge_pages map the frames with huge pages, falling back to the heap if that fails
+   */
+  void AllocateFrames(bool use_huge_pages);
+
+  /**
+   * @brief Allocate a page on disk, preferring a deallocated page close to the hint over growing the file. Caller
+   * should acquire the latch before calling this function.
+   * @param hint the page to stay close to, INVALID_PAGE_ID for no preference
+   * @param extents the extents to take the page from, nullptr to take it from the free pages or the end of the file
+   * @param[out] reused true if a deallocated page was reused
    * @return the id of the allocated page
    */
-  auto AllocatePage() -> page_id_t;
+  auto AllocatePage(page_id_t hint, ExtentAllocator *extents, bool *reused) -> page_id_t;
+
+  /**
+   * @brief Create a new page, see NewPgNearImp() and NewPgInExtentImp().
+   * @param[out] page_id id of created page
+   * @param hint the page to stay close to, INVALID_PAGE_ID for no preference
+   * @param extents the extents to take the page from, nullptr for none
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgInternal(page_id_t *page_id, page_id_t hint, ExtentAllocator *extents) -> Page *;
+
+  /**
+   * @brief Fetch a page, see FetchPgWithStrategyImp() and FetchPgReadOnlyImp(). A fetch that may modify the page and
+   * finds it used in place in the mapped database file copies it into the frame first.
+   * @param page_id id of page to be fetched
+   * @param strategy the ring of the bulk read, may be nullptr
+   * @param read_only true if the caller only reads the page
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPgInternal(page_id_t page_id, BufferAccessStrategy *strategy, bool read_only) -> Page *;
+
+  /**
+   * @brief Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions to
+   * validate input data and ensure that a parallel BPM is routing requests to the correct BPI.
+   * @param page_id id of the page to validate
+   */
+  void ValidatePageId(page_id_t page_id) const;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Deallocate a page on disk, so that AllocatePage() can hand it out again. A page id the disk manager did not
+   * hand out, or that was deallocated already, is left alone. Caller should acquire the latch before calling this
+   * function.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
+  void DeallocatePage(page_id_t page_id) {
+    if (disk_manager_->IsHandedOut(page_id)) {
+      disk_manager_->DeallocatePage(page_id);
+    }
   }
 };
 }  // namespace bustub
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/** A point-in-time copy of the statistics of one buffer pool manager instance, see BufferPoolStats. */
+struct BufferPoolStatsSnapshot {
+  /** Number of buckets of the fetch latency histogram. Bucket i counts fetches that took [2^i, 2^(i+1)) ns. */
+  static constexpr size_t NUM_LATENCY_BUCKETS = 32;
+
+  /** Index of the instance in its parallel buffer pool manager, 0 if it is not part of one. */
+  uint32_t instance_index_{0};
+  /** Fetches of pages that were resident. */
+  uint64_t hits_{0};
+  /** Fetches of pages that were not resident. */
+  uint64_t misses_{0};
+  /** Pages that were evicted to make room for another page. */
+  uint64_t evictions_{0};
+  /** Dirty pages written back on eviction or by the background writer. */
+  uint64_t writebacks_{0};
+  /** Pages written by FlushPage() and FlushAllPages(). */
+  uint64_t flushes_{0};
+  /** Fetches and new pages that returned nullptr because every frame was pinned. */
+  uint64_t pin_failures_{0};
+  /** Histogram of the latency of FetchPage(), hits and misses alike. */
+  std::array<uint64_t, NUM_LATENCY_BUCKETS> fetch_latency_{};
+
+  /** @return the fraction of the fetches that were hits, 0 if there were no fetches */
+  auto GetHitRatio() const -> double {
+    auto fetches = hits_ + misses_;
+    return fetches == 0 ? 0.0 : static_cast<double>(hits_) / static_cast<double>(fetches);
+  }
+
+  /**
+   * @param fraction the fraction of the fetches, e.g. 0.99 for the 99th percentile
+   * @return an upper bound in ns of the latency of that fraction of the fetches, 0 if there were no fetches
+   */
+  auto GetFetchLatencyPercentile(double fraction) const -> uint64_t {
+    uint64_t fetches = 0;
+    for (auto count : fetch_latency_) {
+      fetches += count;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < NUM_LATENCY_BUCKETS; i++) {
+      seen += fetch_latency_[i];
+      if (fetches > 0 && static_cast<double>(seen) >= fraction * static_cast<double>(fetches)) {
+        return GetBucketUpperBound(i);
+      }
+    }
+    return 0;
+  }
+
+  /** @return the exclusive upper bound in ns of a bucket of the fetch latency histogram */
+  static auto GetBucketUpperBound(size_t bucket) -> uint64_t { return uint64_t{1} << (bucket + 1); }
+};
+
+/**
+ * BufferPoolStats counts what a buffer pool manager instance does. The counters are relaxed atomics that are mostly
+ * bumped under the latch the instance holds anyway, so they are cheap enough to stay on all the time, and can be read
+ * without taking the latch. A snapshot is not an atomic cut across the counters.
+ */
+class BufferPoolStats {
+ public:
+  /** Times a fetch from its creation to its destruction, and adds it to the fetch latency histogram. */
+  class FetchTimer {
+   public:
+    explicit FetchTimer(BufferPoolStats *stats) : stats_(stats), start_(std::chrono::steady_clock::now()) {}
+    ~FetchTimer() {
+      auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+      stats_->RecordFetchLatency(static_cast<uint64_t>(latency.count()));
+    }
+    FetchTimer(const FetchTimer &) = delete;
+    auto operator=(const FetchTimer &) -> FetchTimer & = delete;
+
+   private:
+    BufferPoolStats *stats_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  void AddHit() { hits_.fetch_add(1, std::memory_order_relaxed); }
+  void AddMiss() { misses_.fetch_add(1, std::memory_order_relaxed); }
+  void AddEviction() { evictions_.fetch_add(1, std::memory_order_relaxed); }
+  void AddWritebacks(uint64_t num_pages) { writebacks_.fetch_add(num_pages, std::memory_order_relaxed); }
+  void AddFlushes(uint64_t num_pages) { flushes_.fetch_add(num_pages, std::memory_order_relaxed); }
+  void AddPinFailure() { pin_failures_.fetch_add(1, std::memory_order_relaxed); }
+
+  /** @param latency_ns how long a fetch took */
+  void RecordFetchLatency(uint64_t latency_ns) {
+    // the index of the highest set bit, fetches of 0 ns count as 1 ns
+    auto bucket = std::min<size_t>(63 - __builtin_clzll(latency_ns | 1),
+                                   BufferPoolStatsSnapshot::NUM_LATENCY_BUCKETS - 1);
+    fetch_latency_[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @param instance_index the index the snapshot is labelled with
+   * @return a copy of the current statistics
+   */
+  auto Snapshot(uint32_t instance_index) const -> BufferPoolStatsSnapshot {
+    BufferPoolStatsSnapshot snapshot;
+    snapshot.instance_index_ = instance_index;
+    snapshot.hits_ = hits_.load(std::memory_order_relaxed);
+    snapshot.misses_ = misses_.load(std::memory_order_relaxed);
+    snapshot.evictions_ = evictions_.load(std::memory_order_relaxed);
+    snapshot.writebacks_ = writebacks_.load(std::memory_order_relaxed);
+    snapshot.flushes_ = flushes_.load(std::memory_order_relaxed);
+    snapshot.pin_failures_ = pin_failures_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < BufferPoolStatsSnapshot::NUM_LATENCY_BUCKETS; i++) {
+      snapshot.fetch_latency_[i] = fetch_latency_[i].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+  }
+
+ private:
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+  std::atomic<uint64_t> writebacks_{0};
+  std::atomic<uint64_t> flushes_{0};
+  std::atomic<uint64_t> pin_failures_{0};
+  std::array<std::atomic<uint64_t>, BufferPoolStatsSnapshot::NUM_LATENCY_BUCKETS> fetch_latency_{};
+};
+
+}  // namespace bustub
@@ -12,17 +12,23 @@
 
 #pragma once
 
-#include <list>
-#include <mutex>  // NOLINT
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include "buffer/replacer.h"
 #include "common/config.h"
+#include "common/macros.h"
 
 namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * The replacer is latch-free. Every frame has an atomic reference bit and an atomic state, so recording a hit on a
+ * tracked frame is a single relaxed store. Evict() sweeps the frames with an atomic clock hand, clears the reference
+ * bits it passes, and claims the first evictable frame whose bit is already clear with a compare-and-swap on its
+ * state, so concurrent evictions never pick the same frame.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -32,21 +38,38 @@ class ClockReplacer : public Replacer {
    */
   explicit ClockReplacer(size_t num_pages);
 
+  DISALLOW_COPY_AND_MOVE(ClockReplacer);
+
   /**
    * Destroys the ClockReplacer.
    */
   ~ClockReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
 
-  void Pin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
  private:
-  // TODO(student): implement me!
+  enum class FrameState : uint8_t { UNTRACKED, PINNED, EVICTABLE };
+
+  /** Atomically move a frame from one state to another. @return false if the frame was not in the expected state */
+  auto Transition(frame_id_t frame_id, FrameState expected, FrameState desired) -> bool;
+
+  size_t replacer_size_;
+  std::unique_ptr<std::atomic<FrameState>[]> states_;
+  std::unique_ptr<std::atomic<bool>[]> ref_bits_;
+  /** The clock hand, taken modulo replacer_size_. */
+  std::atomic<size_t> hand_{0};
+  /** Number of frames in the EVICTABLE state. */
+  std::atomic<size_t> curr_size_{0};
 };
 
 }  // namespace bustub
@@ -13,13 +13,14 @@
 #pragma once
 
 #include <algorithm>
+#include <deque>
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <queue>
-#include <unordered_map>
+#include <set>
+#include <tuple>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
@@ -36,7 +37,7 @@ namespace bustub {
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
    *
@@ -54,7 +55,7 @@ class LRUKReplacer {
    *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
    * TODO(P1): Add implementation
@@ -72,7 +73,7 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
@@ -87,6 +88,11 @@ class LRUKReplacer {
    */
   void RecordAccess(frame_id_t frame_id);
 
+  /**
+   * @brief Record an access to the given frame. LRU-K only looks at frame histories, so the page id is ignored.
+   */
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override { RecordAccess(frame_id); }
+
   /**
    * TODO(P1): Add implementation
    *
@@ -104,7 +110,7 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
    * TODO(P1): Add implementation
@@ -123,7 +129,7 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -132,24 +138,41 @@ class LRUKReplacer {
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
+  /**
+   * @brief List the evictable frames in eviction order, i.e. by decreasing backward k-distance.
+   * @param max_frames the maximum number of frames to return
+   * @return up to max_frames evictable frames, the next victim first
+   */
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] size_t current_timestamp_{0};
+  /**
+   * Eviction order of an evictable frame. Frames with fewer than k accesses (+inf backward k-distance) sort before
+   * all others; within each group the frame whose oldest remembered access is earliest comes first. For a frame with
+   * k accesses the oldest remembered access is its k-th most recent one, so the first element of the index is always
+   * the frame with the largest backward k-distance.
+   */
+  using EvictKey = std::tuple<bool, size_t, frame_id_t>;
+
+  struct FrameInfo {
+    /** Timestamps of the last (at most k) accesses, oldest first. Empty if the frame is not tracked. */
+    std::deque<size_t> history_;
+    bool evictable_{false};
+  };
+
+  auto GetEvictKey(frame_id_t frame_id) const -> EvictKey;
+
+  size_t current_timestamp_{0};
   size_t curr_size_{0};
   size_t replacer_size_;
   size_t k_;
 
-  struct MapFrame {
-    bool evictable_{false};
-    size_t use_count_{0};
-    std::list<frame_id_t>::iterator pos_;
-  };
-  std::list<frame_id_t> history_list_;
-  std::list<frame_id_t> cache_list_;
-  std::unordered_map<page_id_t, MapFrame> data_;
+  /** Per-frame access history, indexed by frame id. */
+  std::vector<FrameInfo> frames_;
+  /** Evictable frames ordered by eviction priority. */
+  std::set<EvictKey> evict_index_;
   std::mutex latch_;
 };
 
@@ -12,8 +12,9 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -37,16 +38,32 @@ class LRUReplacer : public Replacer {
    */
   ~LRUReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
-  void Pin(frame_id_t frame_id) override;
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
  private:
-  // TODO(student): implement me!
+  struct FrameInfo {
+    bool tracked_{false};
+    bool evictable_{false};
+    size_t last_access_{0};
+  };
+
+  size_t current_timestamp_{0};
+  size_t replacer_size_;
+  /** Per-frame state, indexed by frame id. */
+  std::vector<FrameInfo> frames_;
+  /** Evictable frames ordered by their last access, least recent first. */
+  std::set<std::pair<size_t, frame_id_t>> lru_;
+  std::mutex latch_;
 };
 
 }  // namespace bustub
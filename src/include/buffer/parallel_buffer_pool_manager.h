@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/config.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool across several independent BufferPoolManagerInstances. Every page
+ * id is owned by exactly one instance (page_id % num_instances), so operations on pages of different instances never
+ * contend on the same latch, page table or replacer.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @brief Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of each instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of each instance
+   * @param use_huge_pages back the frames of each instance with huge pages if the system has them
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRUK, bool use_huge_pages = false);
+
+  /**
+   * @brief Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @brief Return the total size (number of frames) of all the BufferPoolManagerInstances. */
+  auto GetPoolSize() -> size_t override;
+
+  /** @brief Return the number of free or evictable frames of all the BufferPoolManagerInstances. */
+  auto GetNumFreeFrames() -> size_t override;
+
+  /** @brief Return the statistics of every BufferPoolManagerInstance. */
+  auto GetStats() -> std::vector<BufferPoolStatsSnapshot> override;
+
+  /** @brief Return the number of BufferPoolManagerInstances. */
+  auto GetNumInstances() const -> size_t { return instances_.size(); }
+
+  /**
+   * @brief Return the BufferPoolManagerInstance responsible for handling the given page id.
+   * @param page_id id of the page
+   * @return pointer to the BufferPoolManagerInstance responsible for handling the given page id, nullptr if page_id < 0
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
+
+  /** @brief Start the background writer of every BufferPoolManagerInstance. */
+  void RunBackgroundWriter(const BackgroundWriterOptions &options);
+
+  /** @brief Stop the background writer of every BufferPoolManagerInstance. */
+  void StopBackgroundWriter();
+
+ protected:
+  /** @brief Fetch the requested page from the responsible BufferPoolManagerInstance. */
+  auto FetchPgImp(page_id_t page_id) -> Page * override;
+
+  /** @brief Fetch the requested page from the responsible BufferPoolManagerInstance, through its ring. */
+  auto FetchPgWithStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /** @brief Fetch the requested page for reading only from the responsible BufferPoolManagerInstance. */
+  auto FetchPgReadOnlyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /** @brief Pass the access pattern hint on to the disk manager shared by all instances. */
+  void AdviseAccessPatternImp(page_id_t first_page_id, size_t num_pages, AccessPattern pattern) override;
+
+  /** @brief Unpin the target page from the responsible BufferPoolManagerInstance. */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /** @brief Flush the target page to disk through the responsible BufferPoolManagerInstance. */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Create a new page. Instances are tried round robin, starting from a different instance on every call so
+   * that new pages are spread evenly. Each instance is tried at most once; nullptr is returned if all of them are
+   * full of pinned pages.
+   *
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /** @brief Create a new page in the instance that owns the hint, or any other instance if that one is full. */
+  auto NewPgNearImp(page_id_t *page_id, page_id_t hint) -> Page * override;
+
+  /** @brief Create a new page in the instance that owns the next page of the extents, or any other instance. */
+  auto NewPgInExtentImp(page_id_t *page_id, ExtentAllocator *extents) -> Page * override;
+
+  /** @brief Delete the target page from the responsible BufferPoolManagerInstance. */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Flush all the dirty pages of every BufferPoolManagerInstance to disk. The dirty pages of all instances are
+   * sorted by page id together, since adjacent pages belong to different instances, and written in chunks of that
+   * order.
+   */
+  void FlushAllPgsImp() override;
+
+ private:
+  /** Size of a single BufferPoolManagerInstance. */
+  const size_t pool_size_;
+  /** The disk manager shared by all instances. */
+  DiskManager *disk_manager_;
+  /** The shards. Page id p is owned by instances_[p % instances_.size()]. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+  /** Instance that the next NewPgImp() call starts from. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
@@ -12,12 +12,18 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** Replacement policies a BufferPoolManagerInstance can be constructed with. */
+enum class ReplacerType { LRUK, LRU, CLOCK, ARC, TWO_QUEUE };
+
 /**
- * Replacer is an abstract class that tracks page usage.
+ * Replacer is an abstract class that tracks frame usage and picks the frame to evict when the buffer pool is full.
+ * A frame becomes tracked on its first RecordAccess() and stops being tracked when it is evicted or removed.
  */
 class Replacer {
  public:
@@ -25,26 +31,44 @@ class Replacer {
   virtual ~Replacer() = default;
 
   /**
-   * Remove the victim frame as defined by the replacement policy.
-   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
+   * Evict the victim frame as defined by the replacement policy. Only frames that are marked as 'evictable' are
+   * candidates for eviction.
+   * @param[out] frame_id id of frame that was evicted
    * @return true if a victim frame was found, false otherwise
    */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * Record that the given frame was accessed. The page id tells policies that remember evicted pages (ARC, 2Q)
+   * which page was loaded into the frame; the first access after an eviction is always for a new page.
+   * @param frame_id id of frame that received a new access
+   * @param page_id id of the page held by the frame
+   */
+  virtual void RecordAccess(frame_id_t frame_id, page_id_t page_id) = 0;
 
   /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
-   * @param frame_id the id of the frame to pin
+   * Toggle whether a frame is evictable or non-evictable. Untracked frames are ignored.
+   * @param frame_id id of frame whose 'evictable' status will be modified
+   * @param set_evictable whether the given frame is evictable or not
    */
-  virtual void Pin(frame_id_t frame_id) = 0;
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
 
   /**
-   * Unpins a frame, indicating that it can now be victimized.
-   * @param frame_id the id of the frame to unpin
+   * Stop tracking an evictable frame, e.g. because its page was deleted. Unlike Evict(), the page is not remembered.
+   * @param frame_id id of frame to be removed
    */
-  virtual void Unpin(frame_id_t frame_id) = 0;
+  virtual void Remove(frame_id_t frame_id) = 0;
 
-  /** @return the number of elements in the replacer that can be victimized */
+  /** @return the number of elements in the replacer that can be evicted */
   virtual auto Size() -> size_t = 0;
+
+  /**
+   * List the frames that Evict() would pick next, in eviction order, without changing any state. The background
+   * writer uses this to clean dirty pages before they are chosen as victims.
+   * @param max_frames the maximum number of frames to return
+   * @return up to max_frames evictable frames, the next victim first
+   */
+  virtual auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> = 0;
 };
 
 }  // namespace bustub
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full 2Q policy (Johnson & Shasha, VLDB '94).
+ *
+ * Newly loaded pages enter A1in, a FIFO that ignores re-references (they are usually correlated, e.g. several tuples
+ * read from the same page). Pages evicted from A1in are remembered in the ghost FIFO A1out. Only a page that is
+ * loaded again while it is in A1out is considered hot and enters Am, an LRU list. A1in is evicted first whenever it
+ * holds more than Kin frames, so one-off scans never reach Am.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * @brief Create a new TwoQueueReplacer with the recommended Kin = 25% and Kout = 50% of the frames.
+   * @param num_frames the maximum number of frames the TwoQueueReplacer will be required to store
+   */
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TwoQueueReplacer);
+
+  ~TwoQueueReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto EvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+ private:
+  enum class Queue { NONE, A1IN, AM };
+
+  struct FrameInfo {
+    Queue queue_{Queue::NONE};
+    bool evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** Load time for A1in (FIFO order), last access time for Am (LRU order). */
+    size_t timestamp_{0};
+  };
+
+  /** @return the evictable frames of the queue the frame is resident in */
+  auto EvictableQueue(const FrameInfo &frame) -> std::set<std::pair<size_t, frame_id_t>> &;
+
+  size_t replacer_size_;
+  /** Kin, the number of frames A1in may hold before it is evicted first. */
+  size_t max_a1in_size_;
+  /** Kout, the number of page ids A1out remembers. */
+  size_t max_a1out_size_;
+  /** Number of frames resident in A1in, pinned ones included. */
+  size_t a1in_size_{0};
+  size_t current_timestamp_{0};
+
+  /** Per-frame state, indexed by frame id. */
+  std::vector<FrameInfo> frames_;
+  /** Evictable frames of A1in and Am, oldest first. */
+  std::set<std::pair<size_t, frame_id_t>> a1in_;
+  std::set<std::pair<size_t, frame_id_t>> am_;
+  /** Ghost FIFO of page ids evicted from A1in, oldest first. */
+  std::list<page_id_t> a1out_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> a1out_index_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
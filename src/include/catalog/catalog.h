@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -229,11 +231,13 @@ class Catalog {
     // TODO(chi): support both hash index and btree index
     auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap, scanning and sorting on all cores and building the tree
+    // bottom-up rather than inserting key by key; the scan itself uses no more threads than there are free frames
     auto *table_meta = GetTable(table_name);
-    auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    if (!index->BuildFromTable(table_meta->table_.get(), schema, std::max(1U, std::thread::hardware_concurrency()),
+                               txn)) {
+      // The buffer pool had no frame to scan the table with
+      return NULL_INDEX_INFO;
     }
 
     // Get the next OID for the new index
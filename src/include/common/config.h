@@ -33,9 +33,12 @@ static constexpr int INVALID_LSN = -1;
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
 static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
+static constexpr int BUSTUB_EXTENT_SIZE = 64;                                        // number of pages in an extent
+static constexpr int FLUSH_CHUNK_SIZE = 64;  // dirty pages of each buffer pool instance in one batch of FlushAllPages()
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr double BULK_LOAD_FILL_FACTOR = 0.9;  // how full bulk loading packs the nodes of a b+ tree
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
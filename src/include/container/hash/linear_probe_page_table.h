@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_page_table.h
+//
+// Identification: src/include/container/hash/linear_probe_page_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * linear_probe_page_table.h
+ *
+ * Fixed-capacity open-addressing hash table mapping page ids to frame ids
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "container/hash/hash_table.h"
+
+namespace bustub {
+
+/**
+ * LinearProbePageTable maps page ids to frame ids with open addressing and linear probing.
+ *
+ * The table never grows: it is sized for a maximum number of live entries (e.g. the buffer pool size) and kept at most
+ * half full. Every slot is one 64-bit atomic word holding the page id and the frame id, and slots are packed eight to
+ * a cache line, so a lookup usually touches a single line. Find() is lock-free; Insert() and Remove() are serialized by
+ * a writer latch and publish their changes with single atomic stores, so readers never see a torn entry.
+ *
+ * Remove() leaves no tombstone: it shifts the following entries of the probe chain back into the hole (backward-shift
+ * deletion), so probe chains stay as short as in a table that never saw a removal, however long the pool churns. While
+ * entries move, a reader may miss a page that is in the table, so Remove() bumps a sequence counter around the shift
+ * and Find() checks it before it reports a miss, retrying if a shift ran in between.
+ */
+class LinearProbePageTable : public HashTable<page_id_t, frame_id_t> {
+ public:
+  /**
+   * @brief Create a new LinearProbePageTable.
+   * @param max_size the maximum number of entries that will be stored at the same time
+   */
+  explicit LinearProbePageTable(size_t max_size);
+
+  DISALLOW_COPY_AND_MOVE(LinearProbePageTable);
+
+  /**
+   * @brief Find the frame holding the given page.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame of the page, if found
+   * @return true if the page is in the table, false otherwise
+   */
+  auto Find(const page_id_t &page_id, frame_id_t &frame_id) -> bool override;
+
+  /**
+   * @brief Remove the given page from the table.
+   * @param page_id the page to remove
+   * @return true if the page was in the table, false otherwise
+   */
+  auto Remove(const page_id_t &page_id) -> bool override;
+
+  /**
+   * @brief Insert the given page, or overwrite its frame if it is already in the table.
+   * @param page_id the page to insert
+   * @param frame_id the frame of the page
+   */
+  void Insert(const page_id_t &page_id, const frame_id_t &frame_id) override;
+
+  /** @return the number of slots of the table */
+  auto GetCapacity() const -> size_t { return capacity_; }
+
+  /**
+   * @brief Count the slots a lookup of the given page inspects, for testing.
+   * @param page_id the page to look up
+   * @return the number of slots up to the page or the end of its probe chain
+   */
+  auto GetProbeLength(const page_id_t &page_id) -> size_t;
+
+ private:
+  static constexpr size_t SLOTS_PER_BLOCK = 8;
+  /** Page id stored in slots that hold no entry. Probing stops at the first empty slot. */
+  static constexpr uint32_t EMPTY_KEY = static_cast<uint32_t>(INVALID_PAGE_ID);
+  static constexpr uint64_t EMPTY_SLOT = static_cast<uint64_t>(EMPTY_KEY) << 32;
+
+  /** One cache line worth of slots. */
+  struct alignas(64) SlotBlock {
+    std::atomic<uint64_t> slots_[SLOTS_PER_BLOCK];
+  };
+
+  static auto MakeSlot(page_id_t page_id, frame_id_t frame_id) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static auto SlotKey(uint64_t slot) -> uint32_t { return static_cast<uint32_t>(slot >> 32); }
+  static auto SlotValue(uint64_t slot) -> frame_id_t { return static_cast<frame_id_t>(static_cast<uint32_t>(slot)); }
+
+  /** @return the slot a page id hashes to. Fibonacci hashing spreads the strided ids of a sharded pool. */
+  auto HomeSlot(page_id_t page_id) const -> size_t { return HomeSlotOfKey(static_cast<uint32_t>(page_id)); }
+  auto HomeSlotOfKey(uint32_t key) const -> size_t {
+    return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL) >> (64 - capacity_bits_));
+  }
+
+  /**
+   * @brief Look the page up once, without checking for concurrent shifts.
+   * @param[out] index the slot of the page, or the empty slot that ends its probe chain
+   * @return true if the page was found
+   */
+  auto Probe(uint32_t key, size_t *index) -> bool;
+
+  auto Slot(size_t index) -> std::atomic<uint64_t> & {
+    return blocks_[index / SLOTS_PER_BLOCK].slots_[index % SLOTS_PER_BLOCK];
+  }
+
+  /** Number of slots, a power of two. */
+  size_t capacity_;
+  size_t capacity_bits_;
+  std::unique_ptr<SlotBlock[]> blocks_;
+  /** Odd while Remove() shifts entries, bumped twice per shift. */
+  std::atomic<uint64_t> shift_sequence_{0};
+  std::mutex writer_latch_;
+};
+
+}  // namespace bustub
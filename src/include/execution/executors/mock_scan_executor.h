@@ -79,6 +79,9 @@ class MockScanExecutor : public AbstractExecutor {
 
   /** The shuffled output */
   std::vector<size_t> shuffled_idx_;
+
+  /** The rows of a system table, taken when the executor is created */
+  std::vector<Tuple> rows_;
 };
 
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "execution/executor_context.h"
@@ -57,5 +58,8 @@ class SeqScanExecutor : public AbstractExecutor {
 
   // records info for table
   const TableInfo *tableinfo_;
+
+  // private ring of frames, so that scanning a large table does not flush the buffer pool; nullptr for a small table
+  std::shared_ptr<BufferAccessStrategy> strategy_;
 };
 }  // namespace bustub
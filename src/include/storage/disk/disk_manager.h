@@ -13,15 +13,72 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>  // NOLINT
 #include <fstream>
 #include <future>  // NOLINT
-#include <mutex>   // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/free_page_map.h"
 
 namespace bustub {
 
+class DiskManager;
+
+/** How pages are going to be accessed, see DiskManager::AdviseAccessPattern(). */
+enum class AccessPattern { NORMAL, SEQUENTIAL, RANDOM };
+
+/**
+ * DiskRequest is the completion handle of an asynchronous page read or write, see DiskManager::ReadPageAsync().
+ */
+class DiskRequest {
+  friend class DiskManager;
+  friend class UringDiskManager;
+
+ public:
+  /** Shared state of a request, completed by the disk manager. */
+  class State {
+   public:
+    /** Mark the request as completed and wake up its waiters. */
+    void Complete(bool succeeded);
+
+   private:
+    friend class DiskRequest;
+    std::mutex latch_;
+    std::condition_variable cv_;
+    bool done_{false};
+    bool succeeded_{false};
+  };
+
+  /** Create a request that has already completed. */
+  explicit DiskRequest(bool succeeded);
+
+  /**
+   * Create a pending request.
+   * @param state the state the disk manager completes
+   * @param disk_manager the disk manager to submit queued requests to before waiting
+   */
+  DiskRequest(std::shared_ptr<State> state, DiskManager *disk_manager);
+
+  /**
+   * Wait until the I/O completed, submitting it first if it is still queued.
+   * @return true if the I/O succeeded
+   */
+  auto Wait() -> bool;
+
+  /** @return true if the I/O completed */
+  auto IsDone() -> bool;
+
+ private:
+  std::shared_ptr<State> state_;
+  DiskManager *disk_manager_{nullptr};
+};
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
@@ -42,14 +99,32 @@ class DiskManager {
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
    * @param page_id id of the page
    * @param page_data raw page data
+   * @return false if the disk manager noticed that the page was not written
    */
-  virtual void WritePage(page_id_t page_id, const char *page_data);
+  virtual auto WritePage(page_id_t page_id, const char *page_data) -> bool;
+
+  /**
+   * Write a run of adjacent pages to the database file. The default implementation writes them one by one.
+   * @param first_page_id id of the first page
+   * @param pages raw data of the pages, pages[i] is the data of page first_page_id + i
+   * @param num_pages number of pages in the run
+   * @return false if the disk manager noticed that a page was not written
+   */
+  virtual auto WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) -> bool;
+
+  /**
+   * Write a batch of pages, e.g. all pages of the buffer pool. The pages are written in page id order, and each run of
+   * adjacent pages goes to WritePages() at once, so that a large flush is mostly sequential I/O.
+   * @param pages ids and raw data of the pages, sorted in place
+   * @return false if a run of the batch failed, the other runs are still written
+   */
+  auto WritePageBatch(std::vector<std::pair<page_id_t, const char *>> *pages) -> bool;
 
   /**
    * Read a page from the database file.
@@ -58,6 +133,95 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Make all page writes so far durable. WritePage() alone only hands the page to the operating system.
+   */
+  virtual void SyncPages();
+
+  /**
+   * Start reading a page. The request may only be queued until SubmitAsyncIo() is called or the request is waited
+   * for. The default implementation reads synchronously and returns a completed request.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, which must stay valid until the request completed
+   * @return the completion handle of the read
+   */
+  virtual auto ReadPageAsync(page_id_t page_id, char *page_data) -> DiskRequest;
+
+  /**
+   * Start writing a page, see ReadPageAsync(). The default implementation writes synchronously, and the request
+   * reports the result of WritePage().
+   * @param page_id id of the page
+   * @param page_data raw page data, which must stay valid and unchanged until the request completed
+   * @return the completion handle of the write
+   */
+  virtual auto WritePageAsync(page_id_t page_id, const char *page_data) -> DiskRequest;
+
+  /** Submit the asynchronous requests queued so far to the device. */
+  virtual void SubmitAsyncIo() {}
+
+  /**
+   * Get the data of a page without copying it, if the disk manager keeps the database file mapped in memory.
+   * @param page_id id of the page
+   * @return the page data, or nullptr if the page has to be read with ReadPage()
+   */
+  virtual auto GetMappedPage(page_id_t page_id) -> const char * { return nullptr; }
+
+  /**
+   * Hint how a range of pages is going to be accessed, so the operating system can read ahead or refrain from it.
+   * Concurrent scans advise only the pages they are at, so they do not override each other's hints.
+   * @param first_page_id id of the first page of the range
+   * @param num_pages number of pages in the range
+   * @param pattern the expected access pattern, NORMAL to drop an earlier hint
+   */
+  virtual void AdviseAccessPattern(page_id_t first_page_id, size_t num_pages, AccessPattern pattern) {}
+
+  /**
+   * Take a deallocated page out of the free page map, so that it is reused instead of growing the database file.
+   * @param hint the page the new page should be close to, INVALID_PAGE_ID for no preference
+   * @param num_instances the number of buffer pool instances
+   * @param instance_index the instance that allocates, only pages that route to it are returned
+   * @return the id of a free page, or INVALID_PAGE_ID if there is none
+   */
+  auto AllocateFreePage(page_id_t hint, uint32_t num_instances, uint32_t instance_index) -> page_id_t;
+
+  /**
+   * Record in the free page map that a page holds no data anymore.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /**
+   * Grow the database file by a page that belongs to no extent. The pages of each buffer pool instance follow each
+   * other with a stride of num_instances, skipping over the extents handed out by AllocateExtent().
+   * @param num_instances the number of buffer pool instances
+   * @param instance_index the instance that allocates, the page routes to it
+   * @return the id of the new page
+   */
+  auto AllocateNewPage(uint32_t num_instances, uint32_t instance_index) -> page_id_t;
+
+  /**
+   * Hand out an extent of BUSTUB_EXTENT_SIZE contiguous pages, aligned to its size, for a single table or index. An
+   * extent that was entirely deallocated is reused before the database file grows.
+   * @param[out] reused true if the pages of the extent were deallocated pages
+   * @return the id of the first page of the extent
+   */
+  auto AllocateExtent(bool *reused) -> page_id_t;
+
+  /**
+   * Record that a page of an extent was handed out, see ExtentAllocator::AllocatePage().
+   * @param page_id id of the page
+   */
+  void MarkHandedOut(page_id_t page_id);
+
+  /**
+   * @param page_id id of the page
+   * @return true if the page was handed out and not deallocated since, or is a page of the opened file
+   */
+  auto IsHandedOut(page_id_t page_id) -> bool;
+
+  /** @return the number of deallocated pages that were not reused yet */
+  auto GetNumFreePages() -> size_t { return free_page_map_.GetNumFree(); }
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -94,6 +258,20 @@ class DiskManager {
 
  protected:
   auto GetFileSize(const std::string &file_name) -> int;
+  /** Open or create the log file that belongs to file_name_. */
+  void OpenLogFile();
+  /**
+   * Open or create the free page map file and the extent page map file that belong to file_name_. The pages of extents
+   * that were still open when the database was closed go back to the free page map.
+   * @param clear true if the database file was just created, so left over maps must not be used
+   */
+  void OpenFreePageMap(bool clear);
+  /**
+   * Go on allocating behind the pages of a reopened database file: every page below num_pages and every page the free
+   * page map covers counts as handed out, unless it is free.
+   * @param num_pages the number of pages in the database file
+   */
+  void RestoreAllocation(page_id_t num_pages);
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
@@ -101,11 +279,32 @@ class DiskManager {
   std::fstream db_io_;
   std::string file_name_;
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
   // With multiple buffer pool instances, need to protect file access
   std::mutex db_io_latch_;
+  // deallocated pages, persisted next to the database file if there is one
+  FreePageMap free_page_map_;
+  // pages of extents that ExtentAllocator has not handed out yet, persisted like the free page map so the pages of
+  // extents left open by a table or index are not lost when the database is opened again
+  FreePageMap extent_page_map_;
+  // protects the extents and the next new page of each buffer pool instance
+  std::mutex extent_latch_;
+  // first page past every extent and page handed out so far
+  page_id_t next_extent_{0};
+  // extents handed out by AllocateExtent(), AllocateNewPage() skips them
+  std::unordered_set<page_id_t> owned_extents_;
+  // first page AllocateNewPage() may return, the end of the pages the database file had when it was opened
+  page_id_t first_new_page_{0};
+  // next page AllocateNewPage() returns for each buffer pool instance, INVALID_PAGE_ID until the first allocation
+  std::vector<page_id_t> next_new_pages_;
+  // bit i is set if page i is in use: handed out as a new, free or extent page and not deallocated since
+  std::vector<bool> handed_out_;
+
+ private:
+  /** Set or clear the handed out bit of a page. The extent latch must be held. */
+  void SetHandedOut(page_id_t page_id, bool handed_out);
 };
 
 }  // namespace bustub
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.h
+//
+// Identification: src/include/storage/disk/disk_manager_compressed.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager_posix.h"
+
+namespace bustub {
+
+/**
+ * CompressedDiskManager stores every page of the database file compressed with LzCodec, so that half empty table
+ * pages take a fraction of a page on disk and scans read fewer bytes.
+ *
+ * Compressed pages have different sizes, so a page no longer lives at page_id * BUSTUB_PAGE_SIZE. Each page is kept
+ * in a slot of the database file, a multiple of SLOT_UNIT bytes, and a page address map persisted next to the
+ * database file (<db>.map) records the slot of every page. A page is never rewritten in place: every write goes to a
+ * free slot or the end of the file, and the old slot becomes free only once SyncPages() made the map entry that points
+ * to the new one durable, so the map on disk never points to a slot that is being overwritten, not even after a crash.
+ * Pages that do not compress are stored as they are. Free slots are not persisted but found again from the gaps
+ * between the slots in the map.
+ */
+class CompressedDiskManager : public PosixDiskManager {
+ public:
+  /** Slots of the database file are multiples of this many bytes. */
+  static constexpr size_t SLOT_UNIT = 256;
+
+  /**
+   * Creates a new disk manager that stores compressed pages in the specified database file.
+   * @param db_file the file name of the database file to write to
+   */
+  explicit CompressedDiskManager(const std::string &db_file);
+
+  ~CompressedDiskManager() override;
+
+  /**
+   * Shut down the disk manager and close all the file resources.
+   */
+  void ShutDown() override;
+
+  /**
+   * Compress a page and write it to its slot in the database file.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  auto WritePage(page_id_t page_id, const char *page_data) -> bool override;
+
+  /** Write a run of pages one by one, since the slots of adjacent pages need not be adjacent. */
+  auto WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) -> bool override {
+    return DiskManager::WritePages(first_page_id, pages, num_pages);
+  }
+
+  /**
+   * Read a page from its slot in the database file and decompress it. Pages that were never written read as zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Make all page writes and the page address map durable with fdatasync(), then free the slots that the pages
+   * written so far were moved away from.
+   */
+  void SyncPages() override;
+
+  /** @return the number of bytes of page data written to the database file, compare GetNumWrites() pages */
+  auto GetNumBytesWritten() const -> int64_t { return num_bytes_written_.load(); }
+
+ private:
+  /** Where a page is stored, the entry of a page in the page address map. */
+  struct PageAddress {
+    /** Offset of the slot in the database file. */
+    uint64_t offset_;
+    /** Size of the stored page, BUSTUB_PAGE_SIZE if it is stored uncompressed. */
+    uint32_t size_;
+    /** Size of the slot, 0 if the page was never written. */
+    uint32_t capacity_;
+  };
+  static_assert(sizeof(PageAddress) == 16, "page addresses are stored as they are in the map file");
+
+  /** Open or create the page address map that belongs to file_name_, and find the free slots. */
+  void OpenAddressMap(bool clear);
+
+  /**
+   * Take a slot for a page out of the free slots, or append it to the database file. The latch must be held.
+   * @param capacity the size of the slot
+   * @return the offset of the slot
+   */
+  auto AllocateSlot(uint32_t capacity) -> uint64_t;
+
+  /** File descriptor of the page address map, -1 once shut down. */
+  int map_fd_{-1};
+  /** Protects the page addresses and the free slots. */
+  std::mutex latch_;
+  /** Page address map, indexed by page id. */
+  std::vector<PageAddress> addresses_;
+  /** Free slots of the database file, by size. */
+  std::multimap<uint32_t, uint64_t> free_slots_;
+  /** Old slots of rewritten pages, by size. They become free slots once the map is synced. */
+  std::vector<std::pair<uint32_t, uint64_t>> pending_free_slots_;
+  /** End of the last slot of the database file. */
+  uint64_t file_end_{0};
+  std::atomic<int64_t> num_bytes_written_{0};
+};
+
+}  // namespace bustub
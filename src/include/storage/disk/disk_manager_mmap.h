@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_mmap.h
+//
+// Identification: src/include/storage/disk/disk_manager_mmap.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager_posix.h"
+
+namespace bustub {
+
+/**
+ * MmapDiskManager serves a read-mostly copy of a database, e.g. a reporting replica. It maps the database file as it
+ * is at construction into memory, and a buffer pool on top of it uses the mapped pages in place for read-only fetches
+ * instead of copying them into its frames, see GetMappedPage(). The mapping is read-only: pages that are modified live
+ * in frames of the buffer pool and are written with pwrite() like in PosixDiskManager. The mapping is shared, so it
+ * sees those writes. Pages beyond the mapped file are read and written like in PosixDiskManager.
+ */
+class MmapDiskManager : public PosixDiskManager {
+ public:
+  /**
+   * Creates a new disk manager that maps the specified database file.
+   * @param db_file the file name of the database file to map
+   */
+  explicit MmapDiskManager(const std::string &db_file);
+
+  ~MmapDiskManager() override;
+
+  /**
+   * Unmap the database file and close all the file resources.
+   */
+  void ShutDown() override;
+
+  /**
+   * Copy a page out of the mapping, or read it from the file if it is beyond the mapping.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * @param page_id id of the page
+   * @return the page in the mapping, which must not be modified, or nullptr if it is beyond the mapped file
+   */
+  auto GetMappedPage(page_id_t page_id) -> const char * override;
+
+  /**
+   * Pass the access pattern of the mapped part of the range on to the kernel with madvise().
+   * @param first_page_id id of the first page of the range
+   * @param num_pages number of pages in the range
+   * @param pattern the expected access pattern
+   */
+  void AdviseAccessPattern(page_id_t first_page_id, size_t num_pages, AccessPattern pattern) override;
+
+ private:
+  /** The mapped database file, nullptr if the file was empty. */
+  char *mapping_{nullptr};
+  /** Size of the mapping in bytes, whole pages only. */
+  size_t mapping_size_{0};
+};
+
+}  // namespace bustub
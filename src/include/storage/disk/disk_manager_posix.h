@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.h
+//
+// Identification: src/include/storage/disk/disk_manager_posix.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * PosixDiskManager reads and writes pages of the database file with positional pread()/pwrite() on a plain file
+ * descriptor. Unlike DiskManager it needs no latch and no seek, so page I/O from different threads proceeds in
+ * parallel, and it keeps the file size in memory instead of calling stat() on every read. Writes are not flushed to
+ * stable storage one by one; SyncPages() does that with fdatasync(). The log file is handled like in DiskManager.
+ *
+ * In direct I/O mode the database file is opened with O_DIRECT, so pages bypass the kernel page cache and are cached
+ * only by the buffer pool. Direct I/O needs buffers aligned to BUSTUB_PAGE_SIZE, which the buffer pool frames are;
+ * other buffers are copied through an aligned per-thread bounce buffer.
+ */
+class PosixDiskManager : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param direct_io open the database file with O_DIRECT, falling back to buffered I/O if the file system refuses
+   */
+  explicit PosixDiskManager(const std::string &db_file, bool direct_io = false);
+
+  ~PosixDiskManager() override;
+
+  /**
+   * Shut down the disk manager and close all the file resources.
+   */
+  void ShutDown() override;
+
+  /**
+   * Write a page to the database file.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  auto WritePage(page_id_t page_id, const char *page_data) -> bool override;
+
+  /**
+   * Write a run of adjacent pages to the database file with pwritev(), so the run is a single sequential write.
+   * @param first_page_id id of the first page
+   * @param pages raw data of the pages, pages[i] is the data of page first_page_id + i
+   * @param num_pages number of pages in the run
+   * @return false if pwritev() failed
+   */
+  auto WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) -> bool override;
+
+  /**
+   * Read a page from the database file. Pages beyond the end of the file read as zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Make all page writes so far durable with fdatasync().
+   */
+  void SyncPages() override;
+
+  /** @return true if the database file was opened with O_DIRECT */
+  auto IsDirectIo() const -> bool { return direct_io_; }
+
+  /** @return the size of the database file in bytes, including writes still in the page cache */
+  auto GetDbFileSize() const -> int64_t { return db_file_size_.load(std::memory_order_acquire); }
+
+ protected:
+  /** @return true if the buffer can take part in I/O on the database file as it is */
+  auto IsIoAligned(const char *page_data) const -> bool {
+    return !direct_io_ || reinterpret_cast<uintptr_t>(page_data) % BUSTUB_PAGE_SIZE == 0;
+  }
+
+  /** Record that the database file now extends to at least the given offset. */
+  void GrowDbFileSize(int64_t end);
+
+  /** File descriptor of the database file, -1 once shut down. */
+  int db_fd_{-1};
+  /** Whether the database file was opened with O_DIRECT. */
+  bool direct_io_{false};
+  /** Size of the database file, kept up to date by WritePage(). */
+  std::atomic<int64_t> db_file_size_{0};
+};
+
+}  // namespace bustub
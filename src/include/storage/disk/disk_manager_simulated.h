@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_simulated.h
+//
+// Identification: src/include/storage/disk/disk_manager_simulated.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** Latency of a single page I/O: uniform between min_ and max_, plus tail_ with probability tail_probability_. */
+struct LatencyDistribution {
+  std::chrono::microseconds min_{0};
+  std::chrono::microseconds max_{0};
+  /** How often an I/O hits a latency spike, e.g. garbage collection of an SSD. */
+  double tail_probability_{0.0};
+  /** The latency a spike adds. */
+  std::chrono::microseconds tail_{0};
+};
+
+/** The device a SimulatedDiskManager models, see the presets Ssd() and Hdd(). */
+struct DeviceModel {
+  /** Latency of a random page read. */
+  LatencyDistribution read_;
+  /** Latency of a random page write. */
+  LatencyDistribution write_;
+  /** Latency of an I/O on the page right after the page of the previous I/O, if it is cheaper, e.g. no disk seek. */
+  std::optional<LatencyDistribution> sequential_;
+  /** The number of I/Os the device serves at the same time, further I/Os wait in the queue. */
+  uint32_t queue_depth_{1};
+  /** Seed of the latency samples, the same seed and sequence of I/Os gives the same latencies. */
+  uint32_t seed_{15445};
+
+  /** @return a NVMe SSD: about 100us per read, writes absorbed by the device cache, deep queue, rare spikes */
+  static auto Ssd() -> DeviceModel;
+
+  /** @return a 7200 rpm disk: several ms per random I/O for the seek, sequential I/O much cheaper, one I/O at a time */
+  static auto Hdd() -> DeviceModel;
+};
+
+/**
+ * SimulatedDiskManager keeps pages in memory like DiskManagerUnlimitedMemory, but every page I/O takes as long as it
+ * would on the modelled device. Performance features that hide I/O stalls, e.g. read-ahead, the background writer or
+ * asynchronous flushes, can then be evaluated reproducibly on any machine.
+ *
+ * I/Os are served by queue_depth_ device threads in the order they were issued; each one sleeps for the latency of
+ * the I/O and then copies the page. ReadPageAsync() and WritePageAsync() return as soon as the I/O is queued, so up to
+ * queue_depth_ of them are in flight at once; ReadPage() and WritePage() wait for theirs. Latencies are sampled in
+ * issue order from a generator seeded with seed_, so a single-threaded workload sees the same latencies on every run.
+ */
+class SimulatedDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  /**
+   * Creates a new simulated disk and starts its device threads.
+   * @param model the device to model
+   */
+  explicit SimulatedDiskManager(const DeviceModel &model);
+
+  ~SimulatedDiskManager() override;
+
+  /** Finish the queued I/Os and stop the device threads. */
+  void ShutDown() override;
+
+  /**
+   * Write a page, waiting for the device.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  auto WritePage(page_id_t page_id, const char *page_data) -> bool override;
+
+  /**
+   * Write a run of pages, queueing them all before waiting, so up to queue_depth_ of them are written at once.
+   * @param first_page_id id of the first page of the run
+   * @param pages raw page data of the pages first_page_id, first_page_id + 1, ...
+   * @param num_pages length of the run
+   * @return false if a write of the run failed
+   */
+  auto WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) -> bool override;
+
+  /**
+   * Read a page, waiting for the device.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Queue a page read on the device.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, which must stay valid until the request completed
+   * @return the completion handle of the read
+   */
+  auto ReadPageAsync(page_id_t page_id, char *page_data) -> DiskRequest override;
+
+  /**
+   * Queue a page write on the device.
+   * @param page_id id of the page
+   * @param page_data raw page data, which must stay valid and unchanged until the request completed
+   * @return the completion handle of the write
+   */
+  auto WritePageAsync(page_id_t page_id, const char *page_data) -> DiskRequest override;
+
+  /** @return the number of page reads */
+  auto GetNumReads() const -> int { return num_reads_; }
+
+  /** @return the sum of the latencies of all I/Os so far, not counting the time they waited in the queue */
+  auto GetTotalLatency() const -> std::chrono::microseconds {
+    return std::chrono::microseconds(total_latency_us_.load());
+  }
+
+ private:
+  /** A queued I/O, a read if read_data_ is set and a write otherwise. */
+  struct Request {
+    page_id_t page_id_;
+    char *read_data_;
+    const char *write_data_;
+    std::chrono::microseconds latency_;
+    std::shared_ptr<DiskRequest::State> state_;
+  };
+
+  /** Sample the latency of the I/O and queue it. */
+  auto Submit(page_id_t page_id, char *read_data, const char *write_data) -> DiskRequest;
+
+  /** Sample a latency of the distribution. The latch must be held. */
+  auto SampleLatency(const LatencyDistribution &distribution) -> std::chrono::microseconds;
+
+  /** Body of a device thread. */
+  void DeviceThread();
+
+  DeviceModel model_;
+  std::mt19937 rng_;
+  /** The page of the previous I/O, to recognize sequential I/O. */
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  std::deque<Request> queue_;
+  bool stopped_{false};
+  /** Protects the queue and the latency generator. */
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::vector<std::thread> device_threads_;
+  std::atomic<int> num_reads_{0};
+  std::atomic<int64_t> total_latency_us_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.h
+//
+// Identification: src/include/storage/disk/disk_manager_uring.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager_posix.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace bustub {
+
+/**
+ * UringDiskManager issues the asynchronous page reads and writes of PosixDiskManager through an io_uring submission
+ * queue. ReadPageAsync() and WritePageAsync() only queue a request; queued requests are handed to the kernel with a
+ * single system call once a batch is full, on SubmitAsyncIo(), or when one of them is waited for. A completion thread
+ * reaps the completion queue and completes the DiskRequest handles. At most queue_depth requests are outstanding,
+ * further requests block until a slot frees up. The synchronous ReadPage()/WritePage() are inherited unchanged, and
+ * in direct I/O mode requests on unaligned buffers take the synchronous path as well.
+ *
+ * Without io_uring (kernel headers missing at build time, or io_uring_setup() refused at run time) the asynchronous
+ * calls fall back to the synchronous ones, see IsAsync(). They fall back as well once io_uring_enter() failed with an
+ * error that retrying does not fix; the requests that were queued or in flight at that point fail.
+ */
+class UringDiskManager : public PosixDiskManager {
+ public:
+  /** Default number of outstanding requests. */
+  static constexpr uint32_t DEFAULT_QUEUE_DEPTH = 64;
+  /** Default number of queued requests that triggers a submission. */
+  static constexpr uint32_t DEFAULT_BATCH_SIZE = 8;
+
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param queue_depth the maximum number of outstanding requests
+   * @param batch_size the number of queued requests that are submitted together
+   * @param direct_io open the database file with O_DIRECT, see PosixDiskManager
+   */
+  explicit UringDiskManager(const std::string &db_file, uint32_t queue_depth = DEFAULT_QUEUE_DEPTH,
+                            uint32_t batch_size = DEFAULT_BATCH_SIZE, bool direct_io = false);
+
+  ~UringDiskManager() override;
+
+  /**
+   * Wait for the outstanding requests, stop the completion thread and close all the file resources.
+   */
+  void ShutDown() override;
+
+  /**
+   * Queue a read of a page. Pages beyond the end of the file read as zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, which must stay valid until the request completed
+   * @return the completion handle of the read
+   */
+  auto ReadPageAsync(page_id_t page_id, char *page_data) -> DiskRequest override;
+
+  /**
+   * Queue a write of a page.
+   * @param page_id id of the page
+   * @param page_data raw page data, which must stay valid and unchanged until the request completed
+   * @return the completion handle of the write
+   */
+  auto WritePageAsync(page_id_t page_id, const char *page_data) -> DiskRequest override;
+
+  /** Submit the queued requests to the kernel. */
+  void SubmitAsyncIo() override;
+
+  /** @return true if requests go through io_uring, false if they fall back to synchronous I/O */
+  auto IsAsync() const -> bool { return ring_fd_ >= 0 && !ring_failed_; }
+
+  /** @return the number of io_uring_enter() calls that submitted requests */
+  auto GetNumSubmits() -> uint64_t;
+
+ private:
+  /** A request that was queued but has not completed yet. */
+  struct PendingRequest {
+    std::shared_ptr<DiskRequest::State> state_;
+    bool is_write_{false};
+    int64_t offset_{0};
+    char *data_{nullptr};
+  };
+
+  /** Set up the rings, return false if io_uring is unavailable. */
+  auto SetUpRing(uint32_t entries) -> bool;
+  /** Unmap the rings and close the ring file descriptor. */
+  void TearDownRing();
+  /** Put a request into the submission queue, submitting the batch if it is full. */
+  auto QueueRequest(uint8_t opcode, int64_t offset, char *data, bool is_write) -> DiskRequest;
+  /** Push a single submission queue entry, the latch must be held. */
+  void PushSqe(uint8_t opcode, int64_t offset, char *data, uint64_t user_data);
+  /** Submit the queued entries, the latch must be held. */
+  void SubmitLocked();
+  /** Take the entries that were not submitted back out of the submission queue and fail their requests. */
+  void FailQueuedLocked();
+  /** Body of the completion thread. */
+  void ReapCompletions();
+
+  /** How long the completion thread waits for a completion before it checks whether the ring failed. */
+  static constexpr int64_t REAP_TIMEOUT_NS = 100000000;
+
+  uint32_t queue_depth_;
+  uint32_t batch_size_;
+
+  /** File descriptor of the ring, -1 if io_uring is not used. */
+  int ring_fd_{-1};
+  /** Set once io_uring_enter() failed for good, the ring stays set up until ShutDown(). */
+  std::atomic<bool> ring_failed_{false};
+  /** True if the kernel takes a timeout for waiting on completions. */
+  bool timed_wait_{false};
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  io_uring_cqe *cqes_{nullptr};
+
+  /** Protects the submission queue and the bookkeeping below. */
+  std::mutex latch_;
+  /** Signalled whenever a request completed. */
+  std::condition_variable completed_cv_;
+  /** Requests by their user data; user data 0 tells the completion thread to stop. */
+  std::unordered_map<uint64_t, PendingRequest> pending_;
+  uint64_t next_user_data_{1};
+  /** Entries pushed to the submission queue but not submitted yet. */
+  uint32_t num_queued_{0};
+  uint64_t num_submits_{0};
+  std::thread completion_thread_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extent_allocator.h
+//
+// Identification: src/include/storage/disk/extent_allocator.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * ExtentAllocator gives the pages of a single table heap or B+ tree out of extents of their own, so the pages of the
+ * object are physically contiguous even while other objects grow at the same time.
+ *
+ * An extent is BUSTUB_EXTENT_SIZE contiguous pages handed out by DiskManager::AllocateExtent(). Its pages are used in
+ * order; with a parallel buffer pool every instance takes the pages of the extent that route to it. Once an instance
+ * has no page left in the open extents, the allocator opens a new extent, while the other instances go on with their
+ * pages of the older ones. An extent is closed when all its pages were handed out. Only if more extents are open than
+ * there are instances, the oldest one is closed early and its pages that were never handed out go to the free page
+ * map, so they are not lost. The pages of extents that are still open when the allocator goes away are recorded by the
+ * disk manager and go back to the free page map when the database is opened again. The allocator is latched, so
+ * concurrent splits or inserts can share it.
+ */
+class ExtentAllocator {
+ public:
+  ExtentAllocator() = default;
+
+  DISALLOW_COPY_AND_MOVE(ExtentAllocator);
+
+  /**
+   * @brief Take the first unused page of the current extent that routes to the given buffer pool instance, moving on
+   * to a new extent if there is none.
+   * @param disk_manager the disk manager to get extents from
+   * @param num_instances the number of buffer pool instances
+   * @param instance_index the instance that allocates
+   * @param[out] reused true if the page was deallocated before, so its old contents are still on disk
+   * @return the id of the page
+   */
+  auto AllocatePage(DiskManager *disk_manager, uint32_t num_instances, uint32_t instance_index, bool *reused)
+      -> page_id_t;
+
+  /** @return the first unused page of the oldest open extent, or INVALID_PAGE_ID if there is none */
+  auto GetNextPage() -> page_id_t;
+
+ private:
+  /** An extent with pages that were not handed out yet. */
+  struct Extent {
+    /** First page of the extent. */
+    page_id_t first_page_id_{INVALID_PAGE_ID};
+    /** Bit i is set if page first_page_id_ + i was handed out. */
+    uint64_t used_{0};
+    /** True if the extent consists of deallocated pages. */
+    bool reused_{false};
+  };
+
+  /**
+   * @param[out] index the position of the extent of the page in extents_
+   * @return the first unused page of the open extents that routes to the instance, or INVALID_PAGE_ID
+   */
+  auto FindPage(uint32_t num_instances, uint32_t instance_index, size_t *index) const -> page_id_t;
+
+  /** The open extents, oldest first. */
+  std::deque<Extent> extents_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
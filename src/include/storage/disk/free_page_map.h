@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map.h
+//
+// Identification: src/include/storage/disk/free_page_map.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FreePageMap is a bitmap of the pages of a database file that were deallocated and can be handed out again. It is
+ * kept in memory, and if it was opened on a file every change is written through to that file, one 64-bit word of
+ * the bitmap at a time, so the free pages survive a restart. All operations are thread-safe.
+ */
+class FreePageMap {
+ public:
+  FreePageMap() = default;
+
+  ~FreePageMap();
+
+  /**
+   * Load the map from the given file, or create the file, and write all further changes to it.
+   * @param file_name the file of the map
+   * @param clear true to start with no free pages, e.g. because the database file was just created
+   */
+  void Open(const std::string &file_name, bool clear);
+
+  /** Stop writing changes to the file. The map itself stays usable in memory. */
+  void Close();
+
+  /**
+   * Mark a page as free. Freeing a free page does nothing.
+   * @param page_id id of the page
+   */
+  void Free(page_id_t page_id);
+
+  /**
+   * Mark all pages of an extent as free with a single write, see AllocateExtent().
+   * @param first_page_id id of the first page of the extent
+   */
+  void FreeExtent(page_id_t first_page_id);
+
+  /**
+   * Take the given page out of the map. Taking a page that is not free does nothing.
+   * @param page_id id of the page
+   */
+  void Take(page_id_t page_id);
+
+  /**
+   * Take the free page closest to the hint out of the map. Only pages with page_id % stride == offset qualify, so
+   * that each buffer pool instance of a parallel buffer pool gets back only pages it owns.
+   * @param hint the page the new page should be close to, INVALID_PAGE_ID for no preference
+   * @param stride the number of buffer pool instances
+   * @param offset the index of the instance
+   * @return the id of the page, or INVALID_PAGE_ID if no qualifying page is free
+   */
+  auto Allocate(page_id_t hint, uint32_t stride, uint32_t offset) -> page_id_t;
+
+  /**
+   * Take an extent whose pages are all free out of the map. Extents are BUSTUB_EXTENT_SIZE pages, aligned to their
+   * size, so an extent is exactly one word of the bitmap.
+   * @return the id of the first page of the extent, or INVALID_PAGE_ID if no extent is entirely free
+   */
+  auto AllocateExtent() -> page_id_t;
+
+  /** @return true if the page is free */
+  auto IsFree(page_id_t page_id) -> bool;
+
+  /** @return one past the highest free page, 0 if no page is free */
+  auto GetEndPageId() -> page_id_t;
+
+  /** @return the number of free pages */
+  auto GetNumFree() -> size_t;
+
+ private:
+  static constexpr size_t BITS_PER_WORD = 64;
+  static_assert(BITS_PER_WORD == BUSTUB_EXTENT_SIZE, "an extent must be one word of the bitmap");
+
+  /** Find the qualifying page in the word closest to the hint, update the best candidate so far. */
+  void FindInWord(size_t word_index, page_id_t hint, uint32_t stride, uint32_t offset, page_id_t *best);
+
+  /** Write a word of the bitmap through to the file. The latch must be held. */
+  void WriteWord(size_t word_index);
+
+  std::mutex latch_;
+  /** Bit i of word w is set if page w * 64 + i is free. */
+  std::vector<uint64_t> words_;
+  size_t num_free_{0};
+  std::fstream file_;
+};
+
+}  // namespace bustub
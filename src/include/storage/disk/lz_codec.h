@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_codec.h
+//
+// Identification: src/include/storage/disk/lz_codec.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * LzCodec is a small LZ77 codec in the style of LZ4, fast enough to compress every page that goes to disk.
+ *
+ * The input is encoded as a sequence of (literals, match) pairs. Each pair starts with a token byte whose high nibble
+ * is the number of literals and whose low nibble is the match length minus MIN_MATCH; a nibble of 15 is continued by
+ * bytes that are added to it, up to and including the first byte below 255. The literals follow the token, then the
+ * 16-bit little-endian distance of the match back into the output. The last pair has literals only. Matches are found
+ * with a hash table of the 4-byte sequences seen so far, so inputs must be at most 64 KiB.
+ */
+class LzCodec {
+ public:
+  /** The shortest match that is encoded as a match. */
+  static constexpr size_t MIN_MATCH = 4;
+  /** The largest input, limited by the 16-bit match distance. */
+  static constexpr size_t MAX_INPUT_SIZE = 65536;
+
+  /**
+   * Compress a buffer.
+   * @param src the input
+   * @param src_size the size of the input, at most MAX_INPUT_SIZE
+   * @param[out] dst the output buffer
+   * @param dst_capacity the size of the output buffer
+   * @return the size of the compressed data, or 0 if it does not fit into the output buffer
+   */
+  static auto Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) -> size_t;
+
+  /**
+   * Decompress a buffer compressed by Compress().
+   * @param src the compressed data
+   * @param src_size the size of the compressed data
+   * @param[out] dst the output buffer
+   * @param dst_size the size of the original input
+   * @return false if the compressed data is corrupt or does not decompress to exactly dst_size bytes
+   */
+  static auto Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) -> bool;
+};
+
+}  // namespace bustub
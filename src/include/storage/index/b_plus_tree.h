@@ -10,8 +10,11 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <optional>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "concurrency/transaction.h"
@@ -34,6 +37,13 @@ enum class Operation { SEARCH, INSERT, DELETE };
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * With optimistic latching, Insert() and Remove() first descend like a search, holding read latches and write-latching
+ * only the leaf. Only if the leaf would split or underflow do they start over on the pessimistic path, which holds
+ * the root latch and write latches down to the first node that is safe.
+ *
+ * Searches and optimistic writers do not latch the internal pages either. They validate the version of every internal
+ * page they pass (see Page::GetVersion()), latch the leaf, and descend again with read latches if a page changed.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -42,7 +52,8 @@ class BPlusTree {
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     bool optimistic_latching = true);
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -63,6 +74,10 @@ class BPlusTree {
   template <typename PageType>
   auto SplitBptreePage(PageType *page_to_split) -> PageType *;
 
+  // Build this B+ tree bottom-up from entries, filling nodes to fill_factor; false if the tree is not empty.
+  auto BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, double fill_factor = BULK_LOAD_FILL_FACTOR,
+                bool sorted = false) -> bool;
+
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
@@ -111,6 +126,22 @@ class BPlusTree {
  private:
   void UpdateRootPageId(int insert_record = 0);
 
+  // fetch and latch the root page, write-latch it if it is a leaf and write_latch_leaf is set; nullptr if empty
+  auto FetchRootPage(bool write_latch_leaf) -> Page *;
+
+  // find the leaf of the key validating the versions of the internal pages instead of latching them, and latch the
+  // leaf; nullptr if a validation failed or the tree is empty, then the caller descends with latches
+  auto FindLeafPageOlc(const KeyType &key, bool write_latch_leaf, bool leftmost, bool rightmost) -> Page *;
+
+  // find the leaf of the key with read latches, write-latch the leaf only; nullptr if the tree is empty
+  auto FindLeafPageOptimistic(const KeyType &key) -> Page *;
+
+  // insert without splitting, nullopt if the leaf may split and the pessimistic path has to insert
+  auto InsertOptimistic(const KeyType &key, const ValueType &value) -> std::optional<bool>;
+
+  // remove without merging, false if the leaf may underflow and the pessimistic path has to remove
+  auto RemoveOptimistic(const KeyType &key) -> bool;
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
@@ -118,12 +149,19 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // changed only by writers holding root_page_latch_ and the old root's write latch, read without any latch
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  // try InsertOptimistic()/RemoveOptimistic() before taking the root latch for writing, and descend through the
+  // internal pages with FindLeafPageOlc() before latching them
+  bool optimistic_latching_;
+  // the extents the pages of the tree are allocated from, so the tree is contiguous on disk
+  ExtentAllocator extents_;
 
+  // serializes the pessimistic writers, which may change the root; readers and optimistic writers never take it
   ReaderWriterLatch root_page_latch_;
 };
 
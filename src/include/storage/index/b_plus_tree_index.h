@@ -14,11 +14,13 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree.h"
 #include "storage/index/index.h"
+#include "storage/table/table_heap.h"
 
 namespace bustub {
 
@@ -35,6 +37,25 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * Build the still empty index from unsorted entries at once, see BPlusTree::BulkLoad().
+   * @return false if the index is not empty, then nothing is loaded
+   */
+  auto BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, double fill_factor = BULK_LOAD_FILL_FACTOR)
+      -> bool;
+
+  /**
+   * Build the still empty index from all tuples of a table with several threads: the threads scan the table with
+   * TableHeap::ParallelScan(), each sorts the keys it read into a run, the runs are merged pairwise in parallel, and
+   * the merged run is bulk loaded. Of duplicate keys the one with the smallest RID is kept, whatever the threads.
+   * @param table_heap the table the index is on
+   * @param schema the schema of the tuples of the table
+   * @param num_threads the number of threads to scan, sort and merge with
+   * @return false if the index is not empty or the buffer pool had no frame to scan the table, then nothing is loaded
+   */
+  auto BuildFromTable(TableHeap *table_heap, const Schema &schema, size_t num_threads, Transaction *transaction)
+      -> bool;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
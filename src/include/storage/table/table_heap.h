@@ -12,6 +12,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -20,15 +31,56 @@
 
 namespace bustub {
 
+/** Read-ahead counters of a TableHeap. */
+struct ReadAheadStats {
+  /** Pages loaded by read-ahead. */
+  size_t pages_read_ahead_;
+  /** Pages loaded by read-ahead that a scan reached afterwards. */
+  size_t hits_;
+  /** Pages loaded by read-ahead that no scan reached, because the scan was faster or stopped early. */
+  size_t wasted_;
+};
+
+/**
+ * Read-ahead state of one sequential scan, shared by the scan's iterators and its pending read-ahead request. Pages
+ * are identified by their position in the page chain, counted from the page the scan started on.
+ */
+struct TableReadAhead {
+  TableReadAhead(TableHeap *table_heap, std::shared_ptr<BufferAccessStrategy> strategy)
+      : table_heap_(table_heap), strategy_(std::move(strategy)) {}
+  /** Counts the pages that were read ahead but never reached as wasted. */
+  ~TableReadAhead();
+
+  TableHeap *table_heap_;
+  /** The ring of the scan, read-ahead loads pages into it too. */
+  std::shared_ptr<BufferAccessStrategy> strategy_;
+  std::mutex latch_;
+  /** Position of the page the scan is on. */
+  size_t scan_position_{0};
+  /** Pages read ahead that the scan has not reached yet, with their positions, in chain order. */
+  std::deque<std::pair<size_t, page_id_t>> pages_;
+  /** The furthest page known to read-ahead and its position. The next request continues after it. */
+  std::pair<size_t, page_id_t> frontier_{0, INVALID_PAGE_ID};
+  bool request_pending_{false};
+};
+
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
  */
 class TableHeap {
   friend class TableIterator;
+  friend struct TableReadAhead;
 
  public:
-  ~TableHeap() = default;
+  /** Default number of pages a sequential scan loads ahead of itself. */
+  static constexpr size_t DEFAULT_READ_AHEAD_WINDOW = 16;
+  /** Number of page boundaries a scan crosses in chain order before it is considered sequential. */
+  static constexpr size_t READ_AHEAD_TRIGGER = 2;
+  /** Page count of a table that was opened rather than created, its pages are not counted. */
+  static constexpr size_t UNKNOWN_NUM_PAGES = std::numeric_limits<size_t>::max();
+
+  ~TableHeap();
 
   /**
    * Create a table heap without a transaction. (open table)
@@ -102,17 +154,96 @@ class TableHeap {
   /** @return the begin iterator of this table */
   auto Begin(Transaction *txn) -> TableIterator;
 
+  /**
+   * @param txn the transaction performing the scan
+   * @param strategy the ring of frames the scan reads pages into, so that it does not flush the buffer pool
+   * @return the begin iterator of this table
+   */
+  auto Begin(Transaction *txn, std::shared_ptr<BufferAccessStrategy> strategy) -> TableIterator;
+
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
 
+  /**
+   * Scan the table with several threads. The pages are handed out one at a time in chain order to whichever thread
+   * asks next, so only following the chain is serial; reading the tuples of a page and visiting them is not. The next
+   * page is only known once the current one is in memory, so the thread holding the chain fetches the page, and a
+   * miss, with its disk read, holds up the other threads: the table is read from disk at the speed of one thread.
+   *
+   * Every thread pins one page at a time, so there are no more threads than free frames in the buffer pool. If the
+   * pool runs out of frames anyway, a thread waits for the other threads to unpin their pages; if they have none
+   * pinned, the frames are pinned elsewhere and the scan stops.
+   * @param num_threads the number of threads, the calling thread being one of them
+   * @param txn the transaction performing the scan
+   * @param visit called for every tuple with the index of the thread in [0, num_threads) that read it; called
+   * concurrently by different threads, but never concurrently with itself for the same index
+   * @return false if the scan stopped early because the buffer pool had no frame for a page
+   */
+  auto ParallelScan(size_t num_threads, Transaction *txn, const std::function<void(size_t, Tuple &)> &visit)
+      -> bool;
+
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** @return the number of pages of this table, or UNKNOWN_NUM_PAGES if the table was opened */
+  inline auto GetNumPages() const -> size_t { return num_pages_; }
+
+  /**
+   * Set how many pages ahead of itself a sequential scan loads into the buffer pool. The window is capped at 1/8 of
+   * the buffer pool so read-ahead cannot flush the pool, and at half the ring of scans that have one so read-ahead
+   * does not recycle its own pages. 0 disables read-ahead.
+   * @param window the read-ahead window in pages
+   */
+  inline void SetReadAheadWindow(size_t window) { read_ahead_window_ = window; }
+
+  /** @return the read-ahead window in pages */
+  inline auto GetReadAheadWindow() const -> size_t { return read_ahead_window_; }
+
+  /** @return the read-ahead counters of all scans of this table so far */
+  auto GetReadAheadStats() const -> ReadAheadStats;
+
  private:
+  /**
+   * Called by a scan when it moves on to the next page of the chain. Counts read-ahead hits, and asks the read-ahead
+   * thread for more pages once the scan is sequential and has used up half of the window.
+   * @param read_ahead the read-ahead state of the scan, created on the first call
+   * @param strategy the ring of the scan, may be nullptr
+   * @param page_id the page the scan moved on to
+   */
+  void OnScanNextPage(std::shared_ptr<TableReadAhead> *read_ahead,
+                      const std::shared_ptr<BufferAccessStrategy> &strategy, page_id_t page_id);
+
+  /** Body of the read-ahead thread. */
+  void ReadAheadThread();
+
+  /**
+   * Load pages following the read-ahead frontier of a scan into the buffer pool and leave them unpinned.
+   * @param read_ahead the read-ahead state of the scan
+   * @param num_pages the number of pages to load
+   */
+  void ReadAhead(const std::shared_ptr<TableReadAhead> &read_ahead, size_t num_pages);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  /** The extents the pages of this table are allocated from, so the page chain is contiguous on disk. */
+  ExtentAllocator extents_;
+  /** Pages in the chain, tables only grow. */
+  std::atomic<size_t> num_pages_{UNKNOWN_NUM_PAGES};
+
+  std::atomic<size_t> read_ahead_window_{DEFAULT_READ_AHEAD_WINDOW};
+  std::atomic<size_t> pages_read_ahead_{0};
+  std::atomic<size_t> read_ahead_hits_{0};
+  std::atomic<size_t> read_ahead_wasted_{0};
+  /** The read-ahead thread, started by the first sequential scan. */
+  std::thread read_ahead_thread_;
+  /** Pending requests of the read-ahead thread: the scan and the number of pages to load. */
+  std::deque<std::pair<std::shared_ptr<TableReadAhead>, size_t>> read_ahead_requests_;
+  bool read_ahead_stopped_{false};
+  /** Protects the read-ahead thread and its requests. */
+  std::mutex read_ahead_latch_;
+  std::condition_variable read_ahead_cv_;
 };
 
 }  // namespace bustub
@@ -13,7 +13,9 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 
+#include "buffer/buffer_access_strategy.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -21,6 +23,7 @@
 namespace bustub {
 
 class TableHeap;
+struct TableReadAhead;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
@@ -29,10 +32,16 @@ class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn,
+                std::shared_ptr<BufferAccessStrategy> strategy = nullptr);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        strategy_(other.strategy_),
+        read_ahead_(other.read_ahead_),
+        advised_extent_(other.advised_extent_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -54,13 +63,29 @@ class TableIterator {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    strategy_ = other.strategy_;
+    read_ahead_ = other.read_ahead_;
+    advised_extent_ = other.advised_extent_;
     return *this;
   }
 
  private:
+  /**
+   * Advise the extent-sized range around the page the scan is at as read sequentially, and drop the hint of the range
+   * the scan left. Only scans with a strategy, i.e. bulk reads, advise.
+   * @param page_id the page the scan is at, INVALID_PAGE_ID once the scan is done
+   */
+  void AdviseScanRange(page_id_t page_id);
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** Ring of frames the scan reads pages into, nullptr to use the shared buffer pool as usual. */
+  std::shared_ptr<BufferAccessStrategy> strategy_;
+  /** Read-ahead state of the scan, shared with copies of this iterator. Created once the scan leaves its first page. */
+  std::shared_ptr<TableReadAhead> read_ahead_;
+  /** First page of the range the scan advised as sequential, INVALID_PAGE_ID if none. */
+  page_id_t advised_extent_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
@@ -98,8 +98,8 @@ auto Planner::PlanBaseTableRef(const BoundBaseTableRef &table_ref) -> AbstractPl
   BUSTUB_ASSERT(table, "table not found");
 
   if (StringUtil::StartsWith(table->name_, "__")) {
-    // Plan as MockScanExecutor if it is a mock table.
-    if (StringUtil::StartsWith(table->name_, "__mock")) {
+    // Plan as MockScanExecutor if it is a mock table or a system table.
+    if (StringUtil::StartsWith(table->name_, "__mock") || StringUtil::StartsWith(table->name_, "__buffer_pool")) {
       return std::make_shared<MockScanPlanNode>(std::make_shared<Schema>(SeqScanPlanNode::InferScanSchema(table_ref)),
                                                 table->name_);
     }
@@ -11,12 +11,14 @@
 //===----------------------------------------------------------------------===//
 
 #include <sys/stat.h>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
 #include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
+#include <utility>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -36,6 +38,30 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
     LOG_DEBUG("wrong file format");
     return;
   }
+  OpenLogFile();
+
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
+  // directory or file does not exist
+  if (!db_io_.is_open()) {
+    db_io_.clear();
+    // create a new file
+    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
+    if (!db_io_.is_open()) {
+      throw Exception("can't open db file");
+    }
+  }
+  int file_size = GetFileSize(db_file);
+  OpenFreePageMap(file_size <= 0);
+  RestoreAllocation(file_size <= 0 ? 0 : (file_size + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE);
+  buffer_used = nullptr;
+}
+
+/**
+ * Open/create the log file next to the database file
+ */
+void DiskManager::OpenLogFile() {
+  std::string::size_type n = file_name_.rfind('.');
   log_name_ = file_name_.substr(0, n) + ".log";
 
   log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
@@ -48,19 +74,36 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw Exception("can't open dblog file");
     }
   }
+}
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+/**
+ * Open/create the free page map next to the database file
+ */
+void DiskManager::OpenFreePageMap(bool clear) {
+  std::string::size_type n = file_name_.rfind('.');
+  free_page_map_.Open(file_name_.substr(0, n) + ".fsm", clear);
+  extent_page_map_.Open(file_name_.substr(0, n) + ".ext", clear);
+  // the extent allocators that owned these pages are gone, nobody hands them out anymore
+  for (page_id_t page_id = 0; page_id != INVALID_PAGE_ID;) {
+    page_id = extent_page_map_.Allocate(INVALID_PAGE_ID, 1, 0);
+    if (page_id != INVALID_PAGE_ID) {
+      free_page_map_.Free(page_id);
     }
   }
-  buffer_used = nullptr;
+}
+
+/**
+ * Move the allocation cursors behind the pages of the database file and the free page map
+ */
+void DiskManager::RestoreAllocation(page_id_t num_pages) {
+  std::scoped_lock<std::mutex> lock(extent_latch_);
+  const page_id_t end = std::max(num_pages, free_page_map_.GetEndPageId());
+  first_new_page_ = std::max(first_new_page_, end);
+  next_extent_ = std::max(next_extent_, (end + BUSTUB_EXTENT_SIZE - 1) / BUSTUB_EXTENT_SIZE * BUSTUB_EXTENT_SIZE);
+  // which pages of the file are in use is not recorded, so all of them but the free ones count as handed out
+  for (page_id_t page_id = 0; page_id < end; page_id++) {
+    SetHandedOut(page_id, !free_page_map_.IsFree(page_id));
+  }
 }
 
 /**
@@ -72,25 +115,136 @@ void DiskManager::ShutDown() {
     db_io_.close();
   }
   log_io_.close();
+  free_page_map_.Close();
+  extent_page_map_.Close();
+}
+
+auto DiskManager::AllocateFreePage(page_id_t hint, uint32_t num_instances, uint32_t instance_index) -> page_id_t {
+  page_id_t page_id = free_page_map_.Allocate(hint, num_instances, instance_index);
+  if (page_id != INVALID_PAGE_ID) {
+    std::scoped_lock<std::mutex> lock(extent_latch_);
+    SetHandedOut(page_id, true);
+  }
+  return page_id;
+}
+
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  {
+    // cleared before the page is free, so AllocateFreePage() cannot set the bit in between
+    std::scoped_lock<std::mutex> lock(extent_latch_);
+    SetHandedOut(page_id, false);
+  }
+  // e.g. an unused page of an extent that ExtentAllocator closed early
+  extent_page_map_.Take(page_id);
+  free_page_map_.Free(page_id);
+}
+
+auto DiskManager::AllocateNewPage(uint32_t num_instances, uint32_t instance_index) -> page_id_t {
+  std::scoped_lock<std::mutex> lock(extent_latch_);
+  if (next_new_pages_.size() <= instance_index) {
+    next_new_pages_.resize(instance_index + 1, INVALID_PAGE_ID);
+  }
+  const auto stride = static_cast<page_id_t>(num_instances);
+  page_id_t page_id = next_new_pages_[instance_index];
+  if (page_id == INVALID_PAGE_ID) {
+    // the first page of this instance that the database file did not have yet
+    page_id = first_new_page_ + (static_cast<page_id_t>(instance_index) - first_new_page_ % stride + stride) % stride;
+  }
+  // jump to the first page of this instance behind each extent that belongs to a table or index
+  while (owned_extents_.count(page_id / BUSTUB_EXTENT_SIZE * BUSTUB_EXTENT_SIZE) > 0) {
+    page_id_t extent_end = page_id / BUSTUB_EXTENT_SIZE * BUSTUB_EXTENT_SIZE + BUSTUB_EXTENT_SIZE;
+    page_id += (extent_end - page_id + stride - 1) / stride * stride;
+  }
+  next_extent_ = std::max(next_extent_, page_id / BUSTUB_EXTENT_SIZE * BUSTUB_EXTENT_SIZE + BUSTUB_EXTENT_SIZE);
+  next_new_pages_[instance_index] = page_id + stride;
+  SetHandedOut(page_id, true);
+  return page_id;
+}
+
+void DiskManager::MarkHandedOut(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(extent_latch_);
+  SetHandedOut(page_id, true);
+  extent_page_map_.Take(page_id);
+}
+
+auto DiskManager::IsHandedOut(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(extent_latch_);
+  return page_id >= 0 && static_cast<size_t>(page_id) < handed_out_.size() && handed_out_[page_id];
+}
+
+void DiskManager::SetHandedOut(page_id_t page_id, bool handed_out) {
+  if (page_id < 0) {
+    return;
+  }
+  if (static_cast<size_t>(page_id) >= handed_out_.size()) {
+    if (!handed_out) {
+      return;
+    }
+    handed_out_.resize(page_id + 1, false);
+  }
+  handed_out_[page_id] = handed_out;
+}
+
+auto DiskManager::AllocateExtent(bool *reused) -> page_id_t {
+  page_id_t extent = free_page_map_.AllocateExtent();
+  *reused = extent != INVALID_PAGE_ID;
+  std::scoped_lock<std::mutex> lock(extent_latch_);
+  if (!*reused) {
+    extent = next_extent_;
+    next_extent_ += BUSTUB_EXTENT_SIZE;
+  }
+  // the pages of the extent count as handed out only once the extent allocator gives them to a table or index
+  for (page_id_t page_id = extent; page_id < extent + BUSTUB_EXTENT_SIZE; page_id++) {
+    SetHandedOut(page_id, false);
+  }
+  extent_page_map_.FreeExtent(extent);
+  owned_extents_.insert(extent);
+  return extent;
 }
 
 /**
  * Write the contents of the specified page into disk file
  */
-void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
+auto DiskManager::WritePage(page_id_t page_id, const char *page_data) -> bool {
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
   size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
   // set write cursor to offset
   num_writes_ += 1;
   db_io_.seekp(offset);
   db_io_.write(page_data, BUSTUB_PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
-    return;
-  }
   // needs to flush to keep disk file in sync
   db_io_.flush();
+  // check for I/O error, a closed file only sets the failbit
+  if (db_io_.fail()) {
+    LOG_DEBUG("I/O error while writing");
+    db_io_.clear();
+    return false;
+  }
+  return true;
+}
+
+auto DiskManager::WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) -> bool {
+  bool succeeded = true;
+  for (size_t i = 0; i < num_pages; i++) {
+    succeeded = WritePage(first_page_id + static_cast<page_id_t>(i), pages[i]) && succeeded;
+  }
+  return succeeded;
+}
+
+auto DiskManager::WritePageBatch(std::vector<std::pair<page_id_t, const char *>> *pages) -> bool {
+  std::sort(pages->begin(), pages->end());
+  bool succeeded = true;
+  std::vector<const char *> run;
+  for (size_t start = 0; start < pages->size(); start += run.size()) {
+    run.clear();
+    auto first_page_id = (*pages)[start].first;
+    while (start + run.size() < pages->size() &&
+           (*pages)[start + run.size()].first == first_page_id + static_cast<page_id_t>(run.size())) {
+      run.push_back((*pages)[start + run.size()].second);
+    }
+    succeeded = WritePages(first_page_id, run.data(), run.size()) && succeeded;
+  }
+  return succeeded;
 }
 
 /**
@@ -122,6 +276,52 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   }
 }
 
+/**
+ * The stream is flushed on every write already
+ */
+void DiskManager::SyncPages() {}
+
+/**
+ * Synchronous fallback of the asynchronous page I/O
+ */
+auto DiskManager::ReadPageAsync(page_id_t page_id, char *page_data) -> DiskRequest {
+  ReadPage(page_id, page_data);
+  return DiskRequest(true);
+}
+
+auto DiskManager::WritePageAsync(page_id_t page_id, const char *page_data) -> DiskRequest {
+  return DiskRequest(WritePage(page_id, page_data));
+}
+
+void DiskRequest::State::Complete(bool succeeded) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  done_ = true;
+  succeeded_ = succeeded;
+  cv_.notify_all();
+}
+
+DiskRequest::DiskRequest(bool succeeded) : state_(std::make_shared<State>()) {
+  state_->done_ = true;
+  state_->succeeded_ = succeeded;
+}
+
+DiskRequest::DiskRequest(std::shared_ptr<State> state, DiskManager *disk_manager)
+    : state_(std::move(state)), disk_manager_(disk_manager) {}
+
+auto DiskRequest::Wait() -> bool {
+  if (!IsDone() && disk_manager_ != nullptr) {
+    disk_manager_->SubmitAsyncIo();
+  }
+  std::unique_lock<std::mutex> lock(state_->latch_);
+  state_->cv_.wait(lock, [&] { return state_->done_; });
+  return state_->succeeded_;
+}
+
+auto DiskRequest::IsDone() -> bool {
+  std::scoped_lock<std::mutex> lock(state_->latch_);
+  return state_->done_;
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
@@ -0,0 +1,266 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.cpp
+//
+// Identification: src/storage/disk/disk_manager_compressed.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_compressed.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "storage/disk/lz_codec.h"
+
+namespace bustub {
+
+namespace {
+
+/** pread() until the whole range was read. */
+auto ReadFully(int fd, char *data, size_t size, int64_t offset) -> bool {
+  size_t read_count = 0;
+  while (read_count < size) {
+    auto rc = pread(fd, data + read_count, size - read_count, offset + read_count);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      return false;
+    }
+    read_count += rc;
+  }
+  return true;
+}
+
+/** pwrite() until the whole range was written. */
+auto WriteFully(int fd, const char *data, size_t size, int64_t offset) -> bool {
+  size_t written = 0;
+  while (written < size) {
+    auto rc = pwrite(fd, data + written, size - written, offset + written);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      return false;
+    }
+    written += rc;
+  }
+  return true;
+}
+
+}  // namespace
+
+/**
+ * Constructor: open/create the database file, the log file & the page address map
+ */
+CompressedDiskManager::CompressedDiskManager(const std::string &db_file) : PosixDiskManager(db_file) {
+  if (db_fd_ < 0) {
+    return;
+  }
+  OpenAddressMap(db_file_size_ == 0);
+  // the file holds compressed pages, the address map knows how many there are
+  RestoreAllocation(static_cast<page_id_t>(addresses_.size()));
+}
+
+CompressedDiskManager::~CompressedDiskManager() {
+  if (map_fd_ >= 0) {
+    close(map_fd_);
+  }
+}
+
+/**
+ * Close the page address map, the database file and the log file
+ */
+void CompressedDiskManager::ShutDown() {
+  if (map_fd_ >= 0) {
+    close(map_fd_);
+    map_fd_ = -1;
+  }
+  PosixDiskManager::ShutDown();
+}
+
+/**
+ * Open/create the page address map next to the database file
+ */
+void CompressedDiskManager::OpenAddressMap(bool clear) {
+  std::string::size_type n = file_name_.rfind('.');
+  auto map_name = file_name_.substr(0, n) + ".map";
+  map_fd_ = open(map_name.c_str(), O_RDWR | O_CREAT | (clear ? O_TRUNC : 0), 0644);
+  if (map_fd_ < 0) {
+    throw Exception("can't open page address map file");
+  }
+  struct stat stat_buf;
+  if (fstat(map_fd_, &stat_buf) != 0) {
+    throw Exception("can't stat page address map file");
+  }
+  addresses_.resize(stat_buf.st_size / sizeof(PageAddress));
+  if (!addresses_.empty() &&
+      !ReadFully(map_fd_, reinterpret_cast<char *>(addresses_.data()), addresses_.size() * sizeof(PageAddress), 0)) {
+    throw Exception("can't read page address map file");
+  }
+
+  // everything between the slots in use is free
+  std::vector<std::pair<uint64_t, uint32_t>> slots;
+  for (const auto &address : addresses_) {
+    if (address.capacity_ > 0) {
+      slots.emplace_back(address.offset_, address.capacity_);
+    }
+  }
+  std::sort(slots.begin(), slots.end());
+  for (const auto &[offset, capacity] : slots) {
+    if (offset > file_end_) {
+      free_slots_.emplace(static_cast<uint32_t>(offset - file_end_), file_end_);
+    }
+    file_end_ = std::max(file_end_, offset + capacity);
+  }
+}
+
+auto CompressedDiskManager::AllocateSlot(uint32_t capacity) -> uint64_t {
+  auto it = free_slots_.lower_bound(capacity);
+  if (it == free_slots_.end()) {
+    auto offset = file_end_;
+    file_end_ += capacity;
+    return offset;
+  }
+  auto [free_capacity, offset] = *it;
+  free_slots_.erase(it);
+  if (free_capacity > capacity) {
+    free_slots_.emplace(free_capacity - capacity, offset + capacity);
+  }
+  return offset;
+}
+
+/**
+ * Compress the page and write it into its slot of the database file
+ */
+auto CompressedDiskManager::WritePage(page_id_t page_id, const char *page_data) -> bool {
+  char compressed[BUSTUB_PAGE_SIZE];
+  const char *data = compressed;
+  auto size = static_cast<uint32_t>(LzCodec::Compress(page_data, BUSTUB_PAGE_SIZE, compressed, BUSTUB_PAGE_SIZE - 1));
+  if (size == 0) {
+    // the page does not compress, store it as it is
+    data = page_data;
+    size = BUSTUB_PAGE_SIZE;
+  }
+
+  PageAddress address{};
+  address.size_ = size;
+  address.capacity_ = (size + SLOT_UNIT - 1) / SLOT_UNIT * SLOT_UNIT;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    address.offset_ = AllocateSlot(address.capacity_);
+  }
+
+  num_writes_ += 1;
+  if (!WriteFully(db_fd_, data, size, static_cast<int64_t>(address.offset_))) {
+    LOG_DEBUG("I/O error while writing");
+    std::scoped_lock<std::mutex> lock(latch_);
+    free_slots_.emplace(address.capacity_, address.offset_);
+    return false;
+  }
+  num_bytes_written_ += size;
+  GrowDbFileSize(static_cast<int64_t>(address.offset_ + size));
+
+  PageAddress old_address{};
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (static_cast<size_t>(page_id) >= addresses_.size()) {
+      addresses_.resize(page_id + 1, PageAddress{0, 0, 0});
+    }
+    old_address = addresses_[page_id];
+    addresses_[page_id] = address;
+  }
+  // the address goes to the map after the page, so the map never points to a slot that was not written
+  if (!WriteFully(map_fd_, reinterpret_cast<const char *>(&address), sizeof(address),
+                  static_cast<int64_t>(page_id) * static_cast<int64_t>(sizeof(PageAddress)))) {
+    // the map file may still point to the old slot, so it must not be reused before the database is reopened
+    LOG_DEBUG("I/O error while writing the page address map");
+    return false;
+  }
+  if (old_address.capacity_ > 0) {
+    // until the map entry is durable, the map on disk may still point to the old slot after a crash
+    std::scoped_lock<std::mutex> lock(latch_);
+    pending_free_slots_.emplace_back(old_address.capacity_, old_address.offset_);
+  }
+  return true;
+}
+
+/**
+ * Read the page from its slot of the database file and decompress it into the given memory area
+ */
+void CompressedDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  PageAddress address{0, 0, 0};
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (static_cast<size_t>(page_id) < addresses_.size()) {
+      address = addresses_[page_id];
+    }
+  }
+  if (address.capacity_ == 0) {
+    LOG_DEBUG("I/O error reading a page that was never written");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+
+  if (address.size_ == BUSTUB_PAGE_SIZE) {
+    if (!ReadFully(db_fd_, page_data, BUSTUB_PAGE_SIZE, static_cast<int64_t>(address.offset_))) {
+      LOG_DEBUG("I/O error while reading");
+      memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    }
+    return;
+  }
+  char compressed[BUSTUB_PAGE_SIZE];
+  if (!ReadFully(db_fd_, compressed, address.size_, static_cast<int64_t>(address.offset_))) {
+    LOG_DEBUG("I/O error while reading");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+  if (!LzCodec::Decompress(compressed, address.size_, page_data, BUSTUB_PAGE_SIZE)) {
+    LOG_DEBUG("corrupt compressed page");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+  }
+}
+
+/**
+ * Flush the page writes and the page address map to stable storage, then free the slots the map moved away from
+ */
+void CompressedDiskManager::SyncPages() {
+  // map entries written after this point may not be covered by the sync, so their old slots stay pending
+  std::vector<std::pair<uint32_t, uint64_t>> slots;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    slots.swap(pending_free_slots_);
+  }
+  bool synced = true;
+  if (fdatasync(db_fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing");
+    synced = false;
+  }
+  if (synced && fdatasync(map_fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing the page address map");
+    synced = false;
+  }
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (!synced) {
+    pending_free_slots_.insert(pending_free_slots_.end(), slots.begin(), slots.end());
+    return;
+  }
+  for (const auto &[capacity, offset] : slots) {
+    free_slots_.emplace(capacity, offset);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_mmap.cpp
+//
+// Identification: src/storage/disk/disk_manager_mmap.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_mmap.h"
+
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+/**
+ * Constructor: open the database file & log file and map the whole pages of the database file
+ */
+MmapDiskManager::MmapDiskManager(const std::string &db_file) : PosixDiskManager(db_file) {
+  mapping_size_ = GetDbFileSize() / BUSTUB_PAGE_SIZE * BUSTUB_PAGE_SIZE;
+  if (db_fd_ < 0 || mapping_size_ == 0) {
+    mapping_size_ = 0;
+    return;
+  }
+  // read-only, so a page cannot be modified behind the buffer pool's back, and shared, so writes to the file show up
+  void *mapping = mmap(nullptr, mapping_size_, PROT_READ, MAP_SHARED, db_fd_, 0);
+  if (mapping == MAP_FAILED) {
+    PosixDiskManager::ShutDown();
+    throw Exception("can't map db file");
+  }
+  mapping_ = static_cast<char *>(mapping);
+}
+
+MmapDiskManager::~MmapDiskManager() { ShutDown(); }
+
+/**
+ * Unmap the database file, then close the database file and the log file
+ */
+void MmapDiskManager::ShutDown() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+  }
+  PosixDiskManager::ShutDown();
+}
+
+/**
+ * Copy the specified page out of the mapping into the given memory area
+ */
+void MmapDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  const char *mapped_data = GetMappedPage(page_id);
+  if (mapped_data == nullptr) {
+    // e.g. a page that was created after the file was mapped
+    PosixDiskManager::ReadPage(page_id, page_data);
+    return;
+  }
+  memcpy(page_data, mapped_data, BUSTUB_PAGE_SIZE);
+}
+
+auto MmapDiskManager::GetMappedPage(page_id_t page_id) -> const char * {
+  auto offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
+  if (page_id < 0 || offset >= mapping_size_) {
+    return nullptr;
+  }
+  return mapping_ + offset;
+}
+
+void MmapDiskManager::AdviseAccessPattern(page_id_t first_page_id, size_t num_pages, AccessPattern pattern) {
+  auto offset = static_cast<size_t>(first_page_id) * BUSTUB_PAGE_SIZE;
+  if (first_page_id < 0 || offset >= mapping_size_) {
+    return;
+  }
+  auto length = std::min(num_pages * BUSTUB_PAGE_SIZE, mapping_size_ - offset);
+  int advice = MADV_NORMAL;
+  switch (pattern) {
+    case AccessPattern::SEQUENTIAL:
+      advice = MADV_SEQUENTIAL;
+      break;
+    case AccessPattern::RANDOM:
+      advice = MADV_RANDOM;
+      break;
+    case AccessPattern::NORMAL:
+      break;
+  }
+  if (madvise(mapping_ + offset, length, advice) != 0) {
+    LOG_DEBUG("madvise failed");
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,222 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.cpp
+//
+// Identification: src/storage/disk/disk_manager_posix.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_posix.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+namespace {
+
+/** Aligned buffer of the calling thread for direct I/O from and to unaligned buffers. */
+auto BounceBuffer() -> char * {
+  thread_local std::unique_ptr<char, decltype(&std::free)> buffer(
+      static_cast<char *>(std::aligned_alloc(BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE)), &std::free);  // NOLINT
+  return buffer.get();
+}
+
+}  // namespace
+
+/**
+ * Constructor: open/create the database file & log file
+ */
+PosixDiskManager::PosixDiskManager(const std::string &db_file, bool direct_io) {
+  file_name_ = db_file;
+  std::string::size_type n = file_name_.rfind('.');
+  if (n == std::string::npos) {
+    LOG_DEBUG("wrong file format");
+    return;
+  }
+  OpenLogFile();
+
+  if (direct_io) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    if (db_fd_ >= 0) {
+      direct_io_ = true;
+    } else if (errno == EINVAL) {
+      // e.g. tmpfs does not support O_DIRECT
+      LOG_DEBUG("direct I/O not supported, falling back to buffered I/O");
+    }
+  }
+  if (!direct_io_) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(db_fd_, &stat_buf) != 0) {
+    close(db_fd_);
+    throw Exception("can't stat db file");
+  }
+  db_file_size_ = stat_buf.st_size;
+  OpenFreePageMap(db_file_size_ == 0);
+  RestoreAllocation((db_file_size_ + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE);
+}
+
+PosixDiskManager::~PosixDiskManager() {
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+}
+
+/**
+ * Close the database file and the log file
+ */
+void PosixDiskManager::ShutDown() {
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  log_io_.close();
+  free_page_map_.Close();
+  extent_page_map_.Close();
+}
+
+/**
+ * Write the contents of the specified page into disk file
+ */
+auto PosixDiskManager::WritePage(page_id_t page_id, const char *page_data) -> bool {
+  auto offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
+  num_writes_ += 1;
+  if (!IsIoAligned(page_data)) {
+    page_data = static_cast<const char *>(memcpy(BounceBuffer(), page_data, BUSTUB_PAGE_SIZE));
+  }
+  size_t written = 0;
+  while (written < BUSTUB_PAGE_SIZE) {
+    auto rc = pwrite(db_fd_, page_data + written, BUSTUB_PAGE_SIZE - written, offset + written);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while writing");
+      return false;
+    }
+    written += rc;
+  }
+
+  GrowDbFileSize(offset + BUSTUB_PAGE_SIZE);
+  return true;
+}
+
+/**
+ * Write a run of adjacent pages into disk file with as few pwritev() calls as possible
+ */
+auto PosixDiskManager::WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) -> bool {
+  if (!std::all_of(pages, pages + num_pages, [&](const char *page_data) { return IsIoAligned(page_data); })) {
+    // unaligned pages go through the bounce buffer one by one
+    return DiskManager::WritePages(first_page_id, pages, num_pages);
+  }
+  auto offset = static_cast<int64_t>(first_page_id) * BUSTUB_PAGE_SIZE;
+  num_writes_ += static_cast<int>(num_pages);
+  std::vector<iovec> iovs(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    iovs[i].iov_base = const_cast<char *>(pages[i]);
+    iovs[i].iov_len = BUSTUB_PAGE_SIZE;
+  }
+  size_t done = 0;
+  int64_t written = 0;
+  while (done < num_pages) {
+    auto count = static_cast<int>(std::min<size_t>(num_pages - done, IOV_MAX));
+    auto rc = pwritev(db_fd_, &iovs[done], count, offset + written);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while writing");
+      GrowDbFileSize(offset + written);
+      return false;
+    }
+    written += rc;
+    // skip the pages that were written completely, and the written part of a page that was not
+    while (done < num_pages && static_cast<size_t>(rc) >= iovs[done].iov_len) {
+      rc -= static_cast<ssize_t>(iovs[done].iov_len);
+      done++;
+    }
+    if (rc > 0) {
+      iovs[done].iov_base = static_cast<char *>(iovs[done].iov_base) + rc;
+      iovs[done].iov_len -= rc;
+    }
+  }
+
+  GrowDbFileSize(offset + written);
+  return true;
+}
+
+void PosixDiskManager::GrowDbFileSize(int64_t end) {
+  // the file only ever grows, several writers may race to extend it
+  auto size = db_file_size_.load(std::memory_order_relaxed);
+  while (size < end && !db_file_size_.compare_exchange_weak(size, end, std::memory_order_acq_rel)) {
+  }
+}
+
+/**
+ * Read the contents of the specified page into the given memory area
+ */
+void PosixDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  auto offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
+  // check if read beyond file length
+  if (offset >= db_file_size_.load(std::memory_order_acquire)) {
+    LOG_DEBUG("I/O error reading past end of file");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+  if (!IsIoAligned(page_data)) {
+    ReadPage(page_id, BounceBuffer());
+    memcpy(page_data, BounceBuffer(), BUSTUB_PAGE_SIZE);
+    return;
+  }
+
+  size_t read_count = 0;
+  while (read_count < BUSTUB_PAGE_SIZE) {
+    auto rc = pread(db_fd_, page_data + read_count, BUSTUB_PAGE_SIZE - read_count, offset + read_count);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc < 0) {
+      LOG_DEBUG("I/O error while reading");
+      return;
+    }
+    if (rc == 0) {
+      // if file ends before reading BUSTUB_PAGE_SIZE
+      LOG_DEBUG("Read less than a page");
+      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+      return;
+    }
+    read_count += rc;
+  }
+}
+
+/**
+ * Flush the page writes to stable storage
+ */
+void PosixDiskManager::SyncPages() {
+  if (fdatasync(db_fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing");
+  }
+}
+
+}  // namespace bustub
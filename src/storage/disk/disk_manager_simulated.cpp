@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_simulated.cpp
+//
+// Identification: src/storage/disk/disk_manager_simulated.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_simulated.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+using std::chrono::microseconds;
+
+auto DeviceModel::Ssd() -> DeviceModel {
+  DeviceModel model;
+  model.read_ = {microseconds(80), microseconds(120), 0.001, microseconds(2000)};
+  model.write_ = {microseconds(20), microseconds(40), 0.001, microseconds(2000)};
+  model.queue_depth_ = 32;
+  return model;
+}
+
+auto DeviceModel::Hdd() -> DeviceModel {
+  DeviceModel model;
+  model.read_ = {microseconds(4000), microseconds(12000), 0.0, microseconds(0)};
+  model.write_ = {microseconds(4000), microseconds(12000), 0.0, microseconds(0)};
+  model.sequential_ = LatencyDistribution{microseconds(50), microseconds(100), 0.0, microseconds(0)};
+  model.queue_depth_ = 1;
+  return model;
+}
+
+SimulatedDiskManager::SimulatedDiskManager(const DeviceModel &model) : model_(model), rng_(model.seed_) {
+  BUSTUB_ASSERT(model.queue_depth_ > 0, "the device must serve at least one I/O at a time");
+  device_threads_.reserve(model.queue_depth_);
+  for (uint32_t i = 0; i < model.queue_depth_; i++) {
+    device_threads_.emplace_back([this] { DeviceThread(); });
+  }
+}
+
+SimulatedDiskManager::~SimulatedDiskManager() { ShutDown(); }
+
+void SimulatedDiskManager::ShutDown() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stopped_ = true;
+    cv_.notify_all();
+  }
+  for (auto &thread : device_threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  DiskManager::ShutDown();
+}
+
+auto SimulatedDiskManager::WritePage(page_id_t page_id, const char *page_data) -> bool {
+  return WritePageAsync(page_id, page_data).Wait();
+}
+
+auto SimulatedDiskManager::WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) -> bool {
+  std::vector<DiskRequest> requests;
+  requests.reserve(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    requests.push_back(WritePageAsync(first_page_id + static_cast<page_id_t>(i), pages[i]));
+  }
+  bool succeeded = true;
+  for (auto &request : requests) {
+    succeeded = request.Wait() && succeeded;
+  }
+  return succeeded;
+}
+
+void SimulatedDiskManager::ReadPage(page_id_t page_id, char *page_data) { ReadPageAsync(page_id, page_data).Wait(); }
+
+auto SimulatedDiskManager::ReadPageAsync(page_id_t page_id, char *page_data) -> DiskRequest {
+  num_reads_ += 1;
+  return Submit(page_id, page_data, nullptr);
+}
+
+auto SimulatedDiskManager::WritePageAsync(page_id_t page_id, const char *page_data) -> DiskRequest {
+  num_writes_ += 1;
+  return Submit(page_id, nullptr, page_data);
+}
+
+auto SimulatedDiskManager::Submit(page_id_t page_id, char *read_data, const char *write_data) -> DiskRequest {
+  auto state = std::make_shared<DiskRequest::State>();
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (stopped_) {
+    state->Complete(false);
+    return {state, this};
+  }
+  bool sequential = model_.sequential_.has_value() && last_page_id_ != INVALID_PAGE_ID && page_id == last_page_id_ + 1;
+  last_page_id_ = page_id;
+  auto latency = SampleLatency(sequential ? *model_.sequential_ : read_data != nullptr ? model_.read_ : model_.write_);
+  total_latency_us_ += latency.count();
+  queue_.push_back({page_id, read_data, write_data, latency, state});
+  cv_.notify_one();
+  return {state, this};
+}
+
+auto SimulatedDiskManager::SampleLatency(const LatencyDistribution &distribution) -> microseconds {
+  std::uniform_int_distribution<int64_t> uniform(distribution.min_.count(),
+                                                 std::max(distribution.min_, distribution.max_).count());
+  auto latency = microseconds(uniform(rng_));
+  if (distribution.tail_probability_ > 0 && std::bernoulli_distribution(distribution.tail_probability_)(rng_)) {
+    latency += distribution.tail_;
+  }
+  return latency;
+}
+
+void SimulatedDiskManager::DeviceThread() {
+  while (true) {
+    Request request;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      // queued I/Os are still served after a shutdown
+      cv_.wait(lock, [&] { return stopped_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      request = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    std::this_thread::sleep_for(request.latency_);
+    if (request.read_data_ != nullptr) {
+      DiskManagerUnlimitedMemory::ReadPage(request.page_id_, request.read_data_);
+    } else {
+      DiskManagerUnlimitedMemory::WritePage(request.page_id_, request.write_data_);
+    }
+    request.state_->Complete(true);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,352 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.cpp
+//
+// Identification: src/storage/disk/disk_manager_uring.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_uring.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#ifdef BUSTUB_HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+#include "common/logger.h"
+
+namespace bustub {
+
+UringDiskManager::UringDiskManager(const std::string &db_file, uint32_t queue_depth, uint32_t batch_size,
+                                   bool direct_io)
+    : PosixDiskManager(db_file, direct_io),
+      queue_depth_(std::max(queue_depth, 1U)),
+      batch_size_(std::max(batch_size, 1U)) {
+  if (db_fd_ < 0 || !SetUpRing(queue_depth_)) {
+    LOG_DEBUG("io_uring unavailable, falling back to synchronous I/O");
+    return;
+  }
+  completion_thread_ = std::thread([&] { ReapCompletions(); });
+}
+
+UringDiskManager::~UringDiskManager() { ShutDown(); }
+
+/**
+ * Drain the ring, then close the database file and the log file
+ */
+void UringDiskManager::ShutDown() {
+  if (ring_fd_ >= 0) {
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      SubmitLocked();
+      completed_cv_.wait(lock, [&] { return pending_.empty(); });
+      // the stop request can't be submitted to a failed ring, the completion thread notices the failure by itself
+      if (!ring_failed_) {
+#ifdef BUSTUB_HAVE_IO_URING
+        PushSqe(IORING_OP_NOP, 0, nullptr, 0);
+#endif
+        SubmitLocked();
+      }
+    }
+    completion_thread_.join();
+    TearDownRing();
+  }
+  PosixDiskManager::ShutDown();
+}
+
+auto UringDiskManager::ReadPageAsync(page_id_t page_id, char *page_data) -> DiskRequest {
+  if (!IsAsync() || !IsIoAligned(page_data)) {
+    return PosixDiskManager::ReadPageAsync(page_id, page_data);
+  }
+  auto offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
+  if (offset >= GetDbFileSize()) {
+    LOG_DEBUG("I/O error reading past end of file");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return DiskRequest(true);
+  }
+#ifdef BUSTUB_HAVE_IO_URING
+  return QueueRequest(IORING_OP_READ, offset, page_data, false);
+#else
+  return DiskRequest(false);
+#endif
+}
+
+auto UringDiskManager::WritePageAsync(page_id_t page_id, const char *page_data) -> DiskRequest {
+  if (!IsAsync() || !IsIoAligned(page_data)) {
+    return PosixDiskManager::WritePageAsync(page_id, page_data);
+  }
+  num_writes_ += 1;
+  auto offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
+#ifdef BUSTUB_HAVE_IO_URING
+  // the kernel only reads from the buffer of a write
+  return QueueRequest(IORING_OP_WRITE, offset, const_cast<char *>(page_data), true);
+#else
+  return DiskRequest(false);
+#endif
+}
+
+void UringDiskManager::SubmitAsyncIo() {
+  if (!IsAsync()) {
+    return;
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  SubmitLocked();
+}
+
+auto UringDiskManager::GetNumSubmits() -> uint64_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return num_submits_;
+}
+
+auto UringDiskManager::QueueRequest(uint8_t opcode, int64_t offset, char *data, bool is_write) -> DiskRequest {
+  auto state = std::make_shared<DiskRequest::State>();
+  std::unique_lock<std::mutex> lock(latch_);
+  if (pending_.size() >= queue_depth_) {
+    // the queue is full of our own requests, make sure they are on their way before waiting for one of them
+    SubmitLocked();
+    completed_cv_.wait(lock, [&] { return pending_.size() < queue_depth_; });
+  }
+  if (ring_failed_) {
+    // the ring failed after the caller checked IsAsync()
+    return DiskRequest(false);
+  }
+  auto user_data = next_user_data_++;
+  pending_.emplace(user_data, PendingRequest{state, is_write, offset, data});
+  PushSqe(opcode, offset, data, user_data);
+  if (num_queued_ >= batch_size_) {
+    SubmitLocked();
+  }
+  return {std::move(state), this};
+}
+
+#ifdef BUSTUB_HAVE_IO_URING
+
+auto UringDiskManager::SetUpRing(uint32_t entries) -> bool {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  auto fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (fd < 0) {
+    return false;
+  }
+  ring_fd_ = fd;
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    TearDownRing();
+    return false;
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      TearDownRing();
+      return false;
+    }
+  }
+#ifdef IORING_FEAT_EXT_ARG
+  timed_wait_ = (params.features & IORING_FEAT_EXT_ARG) != 0;
+#endif
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  auto *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    TearDownRing();
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  auto *sq = static_cast<char *>(sq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  auto *cq = static_cast<char *>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  return true;
+}
+
+void UringDiskManager::TearDownRing() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+    sqes_ = nullptr;
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  cq_ring_ = nullptr;
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = nullptr;
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+}
+
+void UringDiskManager::PushSqe(uint8_t opcode, int64_t offset, char *data, uint64_t user_data) {
+  // only this thread writes the tail, the kernel reads it once the entries are submitted
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  io_uring_sqe *sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->user_data = user_data;
+  if (opcode == IORING_OP_NOP) {
+    sqe->fd = -1;
+  } else {
+    sqe->fd = db_fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = BUSTUB_PAGE_SIZE;
+    sqe->off = offset;
+  }
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  num_queued_ += 1;
+}
+
+void UringDiskManager::SubmitLocked() {
+  while (num_queued_ > 0) {
+    auto rc = syscall(__NR_io_uring_enter, ring_fd_, num_queued_, 0, 0, nullptr, 0);
+    if (rc < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        continue;
+      }
+      LOG_DEBUG("I/O error while submitting, falling back to synchronous I/O");
+      FailQueuedLocked();
+      return;
+    }
+    num_queued_ -= rc;
+    num_submits_ += 1;
+  }
+}
+
+void UringDiskManager::FailQueuedLocked() {
+  ring_failed_ = true;
+  // the kernel only reads the entries behind the submitted ones in io_uring_enter(), so they can be taken back
+  unsigned tail = *sq_tail_;
+  for (unsigned i = tail - num_queued_; i != tail; ++i) {
+    auto it = pending_.find(sqes_[sq_array_[i & *sq_mask_]].user_data);
+    if (it != pending_.end()) {
+      it->second.state_->Complete(false);
+      pending_.erase(it);
+    }
+  }
+  __atomic_store_n(sq_tail_, tail - num_queued_, __ATOMIC_RELEASE);
+  num_queued_ = 0;
+  completed_cv_.notify_all();
+}
+
+void UringDiskManager::ReapCompletions() {
+  bool stop = false;
+  while (!stop) {
+    unsigned flags = IORING_ENTER_GETEVENTS;
+    const void *arg = nullptr;
+    size_t arg_size = 0;
+#ifdef IORING_ENTER_EXT_ARG
+    // wake up now and then to notice a failed ring, which can't deliver the stop request
+    __kernel_timespec timeout{0, REAP_TIMEOUT_NS};
+    io_uring_getevents_arg ext_arg{};
+    ext_arg.ts = reinterpret_cast<uint64_t>(&timeout);
+    if (timed_wait_) {
+      flags |= IORING_ENTER_EXT_ARG;
+      arg = &ext_arg;
+      arg_size = sizeof(ext_arg);
+    }
+#endif
+    auto rc = syscall(__NR_io_uring_enter, ring_fd_, 0, 1, flags, arg, arg_size);
+    if (rc < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY && errno != ETIME) {
+      // waiting again would fail again right away; the requests in flight can't be reaped anymore
+      LOG_DEBUG("I/O error while waiting for completions, falling back to synchronous I/O");
+      std::scoped_lock<std::mutex> lock(latch_);
+      FailQueuedLocked();
+      for (auto &[user_data, request] : pending_) {
+        request.state_->Complete(false);
+      }
+      pending_.clear();
+      completed_cv_.notify_all();
+      return;
+    }
+    // only this thread moves the head, the kernel moves the tail
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      const io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+      auto user_data = cqe->user_data;
+      auto res = cqe->res;
+      if (user_data == 0) {
+        stop = true;
+        continue;
+      }
+
+      PendingRequest request;
+      {
+        std::scoped_lock<std::mutex> lock(latch_);
+        auto it = pending_.find(user_data);
+        request = std::move(it->second);
+        pending_.erase(it);
+      }
+      bool succeeded = true;
+      if (request.is_write_) {
+        if (res == static_cast<int>(BUSTUB_PAGE_SIZE)) {
+          GrowDbFileSize(request.offset_ + BUSTUB_PAGE_SIZE);
+        } else {
+          LOG_DEBUG("I/O error while writing");
+          succeeded = false;
+        }
+      } else if (res < 0) {
+        LOG_DEBUG("I/O error while reading");
+        succeeded = false;
+      } else if (res < static_cast<int>(BUSTUB_PAGE_SIZE)) {
+        // if file ends before reading BUSTUB_PAGE_SIZE
+        memset(request.data_ + res, 0, BUSTUB_PAGE_SIZE - res);
+      }
+      request.state_->Complete(succeeded);
+      completed_cv_.notify_all();
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+    // once submitting failed no stop request follows, stop after the last request in flight
+    std::scoped_lock<std::mutex> lock(latch_);
+    stop = stop || (ring_failed_ && pending_.empty());
+  }
+}
+
+#else
+
+auto UringDiskManager::SetUpRing(uint32_t entries) -> bool { return false; }
+
+void UringDiskManager::TearDownRing() {}
+
+void UringDiskManager::PushSqe(uint8_t opcode, int64_t offset, char *data, uint64_t user_data) {}
+
+void UringDiskManager::SubmitLocked() {}
+
+void UringDiskManager::FailQueuedLocked() {}
+
+void UringDiskManager::ReapCompletions() {}
+
+#endif
+
+}  // namespace bustub
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extent_allocator.cpp
+//
+// Identification: src/storage/disk/extent_allocator.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/extent_allocator.h"
+
+namespace bustub {
+
+static_assert(BUSTUB_EXTENT_SIZE == 64, "the used pages of an extent are tracked in a 64-bit mask");
+
+auto ExtentAllocator::AllocatePage(DiskManager *disk_manager, uint32_t num_instances, uint32_t instance_index,
+                                   bool *reused) -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  size_t index = 0;
+  page_id_t page_id = FindPage(num_instances, instance_index, &index);
+  if (page_id == INVALID_PAGE_ID) {
+    // the other instances keep their pages of the open extents, unless one of them has stopped allocating for so long
+    // that too many extents are open
+    if (extents_.size() >= num_instances) {
+      const Extent &oldest = extents_.front();
+      for (uint64_t unused = ~oldest.used_; unused != 0; unused &= unused - 1) {
+        disk_manager->DeallocatePage(oldest.first_page_id_ + __builtin_ctzll(unused));
+      }
+      extents_.pop_front();
+    }
+    Extent extent;
+    extent.first_page_id_ = disk_manager->AllocateExtent(&extent.reused_);
+    extents_.push_back(extent);
+    page_id = FindPage(num_instances, instance_index, &index);
+    BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "every instance has a page in a new extent");
+  }
+  Extent &extent = extents_[index];
+  extent.used_ |= uint64_t{1} << (page_id - extent.first_page_id_);
+  *reused = extent.reused_;
+  disk_manager->MarkHandedOut(page_id);
+  if (extent.used_ == ~uint64_t{0}) {
+    extents_.erase(extents_.begin() + index);
+  }
+  return page_id;
+}
+
+auto ExtentAllocator::GetNextPage() -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  size_t index = 0;
+  return FindPage(1, 0, &index);
+}
+
+auto ExtentAllocator::FindPage(uint32_t num_instances, uint32_t instance_index, size_t *index) const -> page_id_t {
+  for (size_t i = 0; i < extents_.size(); i++) {
+    for (uint64_t unused = ~extents_[i].used_; unused != 0; unused &= unused - 1) {
+      page_id_t page_id = extents_[i].first_page_id_ + __builtin_ctzll(unused);
+      if (page_id % num_instances == instance_index) {
+        *index = i;
+        return page_id;
+      }
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+}  // namespace bustub
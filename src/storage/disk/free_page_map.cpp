@@ -0,0 +1,204 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map.cpp
+//
+// Identification: src/storage/disk/free_page_map.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/free_page_map.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+FreePageMap::~FreePageMap() { Close(); }
+
+void FreePageMap::Open(const std::string &file_name, bool clear) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  words_.clear();
+  num_free_ = 0;
+  if (!clear) {
+    file_.open(file_name, std::ios::binary | std::ios::in | std::ios::out);
+  }
+  if (!file_.is_open()) {
+    // start over with an empty map
+    file_.clear();
+    file_.open(file_name, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
+    if (!file_.is_open()) {
+      throw Exception("can't open free page map file");
+    }
+    return;
+  }
+
+  uint64_t word;
+  while (file_.read(reinterpret_cast<char *>(&word), sizeof(word))) {
+    words_.push_back(word);
+    num_free_ += __builtin_popcountll(word);
+  }
+  file_.clear();
+}
+
+void FreePageMap::Close() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (file_.is_open()) {
+    file_.close();
+  }
+}
+
+void FreePageMap::Free(page_id_t page_id) {
+  BUSTUB_ASSERT(page_id >= 0, "cannot free an invalid page");
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto word_index = static_cast<size_t>(page_id) / BITS_PER_WORD;
+  auto bit = uint64_t{1} << (page_id % BITS_PER_WORD);
+  if (word_index >= words_.size()) {
+    words_.resize(word_index + 1, 0);
+  }
+  if ((words_[word_index] & bit) != 0) {
+    return;
+  }
+  words_[word_index] |= bit;
+  num_free_++;
+  WriteWord(word_index);
+}
+
+void FreePageMap::FreeExtent(page_id_t first_page_id) {
+  BUSTUB_ASSERT(first_page_id >= 0 && first_page_id % BITS_PER_WORD == 0, "an extent is one word of the bitmap");
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto word_index = static_cast<size_t>(first_page_id) / BITS_PER_WORD;
+  if (word_index >= words_.size()) {
+    words_.resize(word_index + 1, 0);
+  }
+  num_free_ += BITS_PER_WORD - __builtin_popcountll(words_[word_index]);
+  words_[word_index] = ~uint64_t{0};
+  WriteWord(word_index);
+}
+
+void FreePageMap::Take(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto word_index = static_cast<size_t>(page_id) / BITS_PER_WORD;
+  auto bit = uint64_t{1} << (page_id % BITS_PER_WORD);
+  if (page_id < 0 || word_index >= words_.size() || (words_[word_index] & bit) == 0) {
+    return;
+  }
+  words_[word_index] &= ~bit;
+  num_free_--;
+  WriteWord(word_index);
+}
+
+auto FreePageMap::Allocate(page_id_t hint, uint32_t stride, uint32_t offset) -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (num_free_ == 0) {
+    return INVALID_PAGE_ID;
+  }
+
+  // search outwards from the hint's word; once a page was found, a page in the next ring of words may still be
+  // closer, but none further out
+  auto num_words = static_cast<int64_t>(words_.size());
+  auto hint_word =
+      hint == INVALID_PAGE_ID ? 0 : std::min<int64_t>(hint / static_cast<int64_t>(BITS_PER_WORD), num_words - 1);
+  page_id_t best = INVALID_PAGE_ID;
+  int64_t found_distance = -1;
+  for (int64_t distance = 0; hint_word + distance < num_words || hint_word - distance >= 0; distance++) {
+    if (found_distance >= 0 && distance > found_distance + 1) {
+      break;
+    }
+    if (hint_word + distance < num_words) {
+      FindInWord(hint_word + distance, hint, stride, offset, &best);
+    }
+    if (distance > 0 && hint_word - distance >= 0) {
+      FindInWord(hint_word - distance, hint, stride, offset, &best);
+    }
+    if (best != INVALID_PAGE_ID && found_distance < 0) {
+      found_distance = distance;
+    }
+  }
+  if (best == INVALID_PAGE_ID) {
+    return INVALID_PAGE_ID;
+  }
+
+  auto word_index = static_cast<size_t>(best) / BITS_PER_WORD;
+  words_[word_index] &= ~(uint64_t{1} << (best % BITS_PER_WORD));
+  num_free_--;
+  WriteWord(word_index);
+  return best;
+}
+
+auto FreePageMap::AllocateExtent() -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (num_free_ < BITS_PER_WORD) {
+    return INVALID_PAGE_ID;
+  }
+  for (size_t word_index = 0; word_index < words_.size(); word_index++) {
+    if (words_[word_index] == ~uint64_t{0}) {
+      words_[word_index] = 0;
+      num_free_ -= BITS_PER_WORD;
+      WriteWord(word_index);
+      return static_cast<page_id_t>(word_index * BITS_PER_WORD);
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+void FreePageMap::FindInWord(size_t word_index, page_id_t hint, uint32_t stride, uint32_t offset, page_id_t *best) {
+  auto target = hint == INVALID_PAGE_ID ? 0 : static_cast<int64_t>(hint);
+  for (uint64_t word = words_[word_index]; word != 0; word &= word - 1) {
+    auto page_id = static_cast<page_id_t>(word_index * BITS_PER_WORD + __builtin_ctzll(word));
+    if (page_id % stride != offset) {
+      continue;
+    }
+    if (*best == INVALID_PAGE_ID || std::abs(page_id - target) < std::abs(*best - target)) {
+      *best = page_id;
+    }
+  }
+}
+
+auto FreePageMap::IsFree(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto word_index = static_cast<size_t>(page_id) / BITS_PER_WORD;
+  return word_index < words_.size() && (words_[word_index] & (uint64_t{1} << (page_id % BITS_PER_WORD))) != 0;
+}
+
+auto FreePageMap::GetEndPageId() -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (size_t word_index = words_.size(); word_index > 0; word_index--) {
+    if (words_[word_index - 1] != 0) {
+      return static_cast<page_id_t>(word_index * BITS_PER_WORD - __builtin_clzll(words_[word_index - 1]));
+    }
+  }
+  return 0;
+}
+
+auto FreePageMap::GetNumFree() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return num_free_;
+}
+
+void FreePageMap::WriteWord(size_t word_index) {
+  if (!file_.is_open()) {
+    return;
+  }
+  // words between the old end of the file and this one are written as well, so the file has no holes
+  file_.seekp(0, std::ios::end);
+  auto file_words = static_cast<size_t>(file_.tellp()) / sizeof(uint64_t);
+  auto first = std::min(word_index, file_words);
+  file_.seekp(static_cast<std::streamoff>(first * sizeof(uint64_t)));
+  for (size_t i = first; i <= word_index; i++) {
+    file_.write(reinterpret_cast<const char *>(&words_[i]), sizeof(uint64_t));
+  }
+  file_.flush();
+  if (file_.bad()) {
+    LOG_DEBUG("I/O error while writing free page map");
+  }
+}
+
+}  // namespace bustub
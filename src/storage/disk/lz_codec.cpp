@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_codec.cpp
+//
+// Identification: src/storage/disk/lz_codec.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/lz_codec.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+/** Number of bits of the hash of a 4-byte sequence, i.e. log2 of the size of the match finder table. */
+constexpr size_t HASH_BITS = 12;
+/** Largest value of a nibble of the token, which means the length continues in the following bytes. */
+constexpr size_t NIBBLE_MAX = 15;
+
+auto Load32(const char *p) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+auto Hash(uint32_t sequence) -> size_t { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Append the continuation of a length whose nibble is NIBBLE_MAX. */
+auto PutLength(size_t length, char *dst, size_t dst_capacity, size_t *op) -> bool {
+  for (; length >= 255; length -= 255) {
+    if (*op >= dst_capacity) {
+      return false;
+    }
+    dst[(*op)++] = static_cast<char>(255);
+  }
+  if (*op >= dst_capacity) {
+    return false;
+  }
+  dst[(*op)++] = static_cast<char>(length);
+  return true;
+}
+
+/** Read the continuation of a length whose nibble is NIBBLE_MAX, adding it to the length. */
+auto GetLength(const char *src, size_t src_size, size_t *ip, size_t *length) -> bool {
+  while (*ip < src_size) {
+    auto byte = static_cast<uint8_t>(src[(*ip)++]);
+    *length += byte;
+    if (byte < 255) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/** Append a pair of literals and a match. A match length of 0 makes it the last pair, which has literals only. */
+auto PutSequence(const char *literals, size_t num_literals, size_t distance, size_t match_length, char *dst,
+                 size_t dst_capacity, size_t *op) -> bool {
+  if (*op >= dst_capacity) {
+    return false;
+  }
+  auto literals_nibble = std::min(num_literals, NIBBLE_MAX);
+  auto match_nibble = match_length == 0 ? 0 : std::min(match_length - LzCodec::MIN_MATCH, NIBBLE_MAX);
+  dst[(*op)++] = static_cast<char>(literals_nibble << 4 | match_nibble);
+  if (literals_nibble == NIBBLE_MAX && !PutLength(num_literals - NIBBLE_MAX, dst, dst_capacity, op)) {
+    return false;
+  }
+  if (dst_capacity - *op < num_literals) {
+    return false;
+  }
+  memcpy(dst + *op, literals, num_literals);
+  *op += num_literals;
+  if (match_length == 0) {
+    return true;
+  }
+
+  if (dst_capacity - *op < 2) {
+    return false;
+  }
+  dst[(*op)++] = static_cast<char>(distance & 0xff);
+  dst[(*op)++] = static_cast<char>(distance >> 8);
+  return match_nibble < NIBBLE_MAX ||
+         PutLength(match_length - LzCodec::MIN_MATCH - NIBBLE_MAX, dst, dst_capacity, op);
+}
+
+}  // namespace
+
+auto LzCodec::Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) -> size_t {
+  if (src_size > MAX_INPUT_SIZE) {
+    return 0;
+  }
+  // position of the last occurrence of each hashed 4-byte sequence
+  std::array<int32_t, 1 << HASH_BITS> table;
+  table.fill(-1);
+
+  size_t ip = 0;
+  size_t anchor = 0;
+  size_t op = 0;
+  while (ip + MIN_MATCH <= src_size) {
+    auto sequence = Load32(src + ip);
+    auto &slot = table[Hash(sequence)];
+    auto ref = slot;
+    slot = static_cast<int32_t>(ip);
+    if (ref < 0 || Load32(src + ref) != sequence) {
+      ip++;
+      continue;
+    }
+    size_t match_length = MIN_MATCH;
+    while (ip + match_length < src_size && src[ref + match_length] == src[ip + match_length]) {
+      match_length++;
+    }
+    if (!PutSequence(src + anchor, ip - anchor, ip - ref, match_length, dst, dst_capacity, &op)) {
+      return 0;
+    }
+    ip += match_length;
+    anchor = ip;
+  }
+  if (anchor < src_size && !PutSequence(src + anchor, src_size - anchor, 0, 0, dst, dst_capacity, &op)) {
+    return 0;
+  }
+  return op;
+}
+
+auto LzCodec::Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) -> bool {
+  size_t ip = 0;
+  size_t op = 0;
+  while (ip < src_size) {
+    auto token = static_cast<uint8_t>(src[ip++]);
+    size_t num_literals = token >> 4;
+    if (num_literals == NIBBLE_MAX && !GetLength(src, src_size, &ip, &num_literals)) {
+      return false;
+    }
+    if (src_size - ip < num_literals || dst_size - op < num_literals) {
+      return false;
+    }
+    memcpy(dst + op, src + ip, num_literals);
+    ip += num_literals;
+    op += num_literals;
+    if (ip == src_size) {
+      break;
+    }
+
+    if (src_size - ip < 2) {
+      return false;
+    }
+    size_t distance = static_cast<uint8_t>(src[ip]) | static_cast<size_t>(static_cast<uint8_t>(src[ip + 1])) << 8;
+    ip += 2;
+    size_t match_length = (token & NIBBLE_MAX) + MIN_MATCH;
+    if ((token & NIBBLE_MAX) == NIBBLE_MAX && !GetLength(src, src_size, &ip, &match_length)) {
+      return false;
+    }
+    if (distance == 0 || distance > op || dst_size - op < match_length) {
+      return false;
+    }
+    // byte by byte, since a match may overlap the output it copies, e.g. a run of zeros
+    for (size_t i = 0; i < match_length; i++) {
+      dst[op + i] = dst[op + i - distance];
+    }
+    op += match_length;
+  }
+  return op == dst_size;
+}
+
+}  // namespace bustub
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 #include "common/exception.h"
@@ -7,15 +9,44 @@
 #include "storage/page/header_page.h"
 
 namespace bustub {
+
+namespace {
+
+/*
+ * Sizes of the nodes that num_entries entries are packed into by BulkLoad(), per_node entries each. A last node that
+ * would have fewer than min_size entries takes the entries of the node before it, or shares them if both together
+ * exceed capacity, so that no node but a root underflows.
+ */
+auto PackNodes(size_t num_entries, size_t per_node, size_t min_size, size_t capacity) -> std::vector<size_t> {
+  std::vector<size_t> sizes(num_entries / per_node, per_node);
+  size_t rest = num_entries % per_node;
+  if (rest == 0) {
+    return sizes;
+  }
+  if (sizes.empty() || rest >= min_size) {
+    sizes.push_back(rest);
+  } else if (sizes.back() + rest <= capacity) {
+    sizes.back() += rest;
+  } else {
+    size_t total = sizes.back() + rest;
+    sizes.back() = total - total / 2;
+    sizes.push_back(total / 2);
+  }
+  return sizes;
+}
+
+}  // namespace
+
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, bool optimistic_latching)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(internal_max_size),
+      optimistic_latching_(optimistic_latching) {}
 
 /*
  * Helper function to decide whether current b+tree is empty
@@ -26,17 +57,165 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return this->root_page_id_ == INV
  * SEARCH
  *****************************************************************************/
 
+/*
+ * Fetch and latch the root page without any tree-wide latch.
+ * The root only changes while the old root is write-latched, and root_page_id_ is stored before that latch is
+ * released. So a latched page that root_page_id_ still names is the root until it is unlatched; otherwise the root
+ * changed during the fetch and we retry.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchRootPage(bool write_latch_leaf) -> Page * {
+  while (true) {
+    page_id_t root_page_id = root_page_id_.load();
+    if (root_page_id == INVALID_PAGE_ID) {
+      return nullptr;
+    }
+    auto *page = buffer_pool_manager_->FetchPage(root_page_id);
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    bool write_latched = write_latch_leaf && node->IsLeafPage();
+    if (write_latched) {
+      page->WLatch();
+    } else {
+      page->RLatch();
+    }
+    // the page type is checked again, in case the page was recycled as another root while it was unlatched
+    if (root_page_id_.load() == root_page_id && write_latched == (write_latch_leaf && node->IsLeafPage())) {
+      return page;
+    }
+    if (write_latched) {
+      page->WUnlatch();
+    } else {
+      page->RUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(root_page_id, false);
+  }
+}
+
+/*
+ * Descend to the leaf without latching the internal pages: read the version of a page, read the child from it, and
+ * validate the version, so readers only pin the pages they pass. The leaf is latched as usual. A parent is validated
+ * once more after the version or the latch of the child was taken, which catches the child being split or merged in
+ * between, since that changes the parent too.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPageOlc(const KeyType &key, bool write_latch_leaf, bool leftmost, bool rightmost)
+    -> Page * {
+  page_id_t root_page_id = root_page_id_.load();
+  if (root_page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  auto *page = buffer_pool_manager_->FetchPage(root_page_id);
+  if (page == nullptr) {
+    return nullptr;
+  }
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  auto latch_leaf = [write_latch_leaf](Page *leaf) {
+    if (write_latch_leaf) {
+      leaf->WLatch();
+    } else {
+      leaf->RLatch();
+    }
+  };
+  auto unlatch_leaf = [write_latch_leaf](Page *leaf) {
+    if (write_latch_leaf) {
+      leaf->WUnlatch();
+    } else {
+      leaf->RUnlatch();
+    }
+  };
+
+  uint64_t version = page->GetVersion();
+  if (node->IsLeafPage()) {
+    // a leaf root is latched right away, like FetchRootPage() does
+    latch_leaf(page);
+    if (root_page_id_.load() == root_page_id && node->IsLeafPage()) {
+      return page;
+    }
+    unlatch_leaf(page);
+    buffer_pool_manager_->UnpinPage(root_page_id, false);
+    return nullptr;
+  }
+  // any later change of the root write-latches this page, and fails a validation below
+  if (root_page_id_.load() != root_page_id) {
+    buffer_pool_manager_->UnpinPage(root_page_id, false);
+    return nullptr;
+  }
+
+  while (true) {
+    auto *internal_page = reinterpret_cast<InternalPage *>(node);
+    // the page may be torn, check the size before searching it
+    int size = internal_page->GetSize();
+    if (size < 1 || size > internal_max_size_ || !page->ValidateVersion(version)) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return nullptr;
+    }
+    page_id_t child_page_id;
+    if (leftmost) {
+      child_page_id = internal_page->ValueAt(0);
+    } else if (rightmost) {
+      child_page_id = internal_page->ValueAt(size - 1);
+    } else {
+      child_page_id = internal_page->FindValueOnInternalPage(key, comparator_);
+    }
+    if (!page->ValidateVersion(version)) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return nullptr;
+    }
+
+    auto *child_page = buffer_pool_manager_->FetchPage(child_page_id);
+    if (child_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return nullptr;
+    }
+    auto *child_node = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
+    uint64_t child_version = child_page->GetVersion();
+    bool child_is_leaf = child_node->IsLeafPage();
+    if (child_is_leaf) {
+      latch_leaf(child_page);
+    }
+    bool valid = page->ValidateVersion(version) && child_is_leaf == child_node->IsLeafPage();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    if (!valid) {
+      if (child_is_leaf) {
+        unlatch_leaf(child_page);
+      }
+      buffer_pool_manager_->UnpinPage(child_page_id, false);
+      return nullptr;
+    }
+    if (child_is_leaf) {
+      return child_page;
+    }
+
+    page = child_page;
+    node = child_node;
+    version = child_version;
+  }
+}
+
 // function to get page[key] from B+ tree by trversing the tree
+// SEARCH returns nullptr if the tree is empty; INSERT and DELETE expect the caller to hold root_page_latch_
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, Operation operation, Transaction *transaction, bool leftmost,
                                   bool rightmost) -> Page * {
-  auto *root_page = buffer_pool_manager_->FetchPage(root_page_id_);
-  auto *root_tree_page = reinterpret_cast<BPlusTreePage *>(root_page->GetData());
-
+  Page *root_page;
   if (operation == Operation::SEARCH) {
-    root_page_latch_.RUnlock();
-    root_page->RLatch();
+    if (optimistic_latching_) {
+      auto *leaf_page = FindLeafPageOlc(key, false, leftmost, rightmost);
+      if (leaf_page != nullptr) {
+        return leaf_page;
+      }
+    }
+    // a validation failed or the tree is empty, descend with read latches
+    root_page = FetchRootPage(false);
+    if (root_page == nullptr) {
+      return nullptr;
+    }
   } else {
+    root_page = buffer_pool_manager_->FetchPage(root_page_id_);
+  }
+  auto *root_tree_page = reinterpret_cast<BPlusTreePage *>(root_page->GetData());
+
+  if (operation != Operation::SEARCH) {
     root_page->WLatch();
     if (operation == Operation::DELETE && root_tree_page->GetSize() > 2) {
       ReleaseLatchFromQueue(transaction);
@@ -99,6 +278,39 @@ auto BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, Operation operation, Trans
   return root_page;
 }
 
+/*
+ * Descend like a search, but write-latch the leaf instead of read-latching it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPageOptimistic(const KeyType &key) -> Page * {
+  auto *leaf_page = FindLeafPageOlc(key, true, false, false);
+  if (leaf_page != nullptr) {
+    return leaf_page;
+  }
+  auto *page = FetchRootPage(true);
+  if (page == nullptr) {
+    return nullptr;
+  }
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+
+  while (!node->IsLeafPage()) {
+    auto *internal_page = reinterpret_cast<InternalPage *>(node);
+    auto *child_page = buffer_pool_manager_->FetchPage(internal_page->FindValueOnInternalPage(key, comparator_));
+    auto *child_node = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
+    if (child_node->IsLeafPage()) {
+      child_page->WLatch();
+    } else {
+      child_page->RLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+
+    page = child_page;
+    node = child_node;
+  }
+  return page;
+}
+
 /*
  * Return the only value that associated with input key
  * This method is used for point query
@@ -106,9 +318,11 @@ auto BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, Operation operation, Trans
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
-  root_page_latch_.RLock();
   // find leaf node first
   Page *page = FindLeafPage(key, Operation::SEARCH, transaction);
+  if (page == nullptr) {
+    return false;
+  }
 
   auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
 
@@ -133,16 +347,19 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
 // to init a whole new B+ tree
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::InitNewTree(const KeyType &key, const ValueType &value) -> void {
-  Page *page = buffer_pool_manager_->NewPage(&root_page_id_);
+  page_id_t root_page_id;
+  Page *page = buffer_pool_manager_->NewPageInExtent(&root_page_id, &extents_);
 
   BUSTUB_ASSERT(page != nullptr, "buffer_pool_manager unable init new page(NewPage: false)");
 
   auto leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
-  leaf_page->Init(root_page_id_, INVALID_PAGE_ID, leaf_max_size_);
+  leaf_page->Init(root_page_id, INVALID_PAGE_ID, leaf_max_size_);
   leaf_page->Insert(key, value, comparator_);
 
   buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
 
+  // publish the root once it is complete, readers do not take root_page_latch_
+  root_page_id_.store(root_page_id);
   UpdateRootPageId(1);
 }
 
@@ -150,11 +367,12 @@ INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *src_leaf, BPlusTreePage *dst_leaf, const KeyType &dst_start_key,
                                       Transaction *transaction) -> void {
   if (src_leaf->IsRootPage()) {
-    auto *page = buffer_pool_manager_->NewPage(&root_page_id_);
+    page_id_t root_page_id;
+    auto *page = buffer_pool_manager_->NewPageInExtent(&root_page_id, &extents_);
     BUSTUB_ASSERT(page != nullptr, "In InsertIntoParent(): buffer_pool_manager_->NewPage failed");
 
     auto *n_root_page = reinterpret_cast<InternalPage *>(page->GetData());
-    n_root_page->Init(root_page_id_, INVALID_PAGE_ID, internal_max_size_);
+    n_root_page->Init(root_page_id, INVALID_PAGE_ID, internal_max_size_);
 
     // param: old value, new key, new value
     n_root_page->InitNewRoot(src_leaf->GetPageId(), dst_start_key, dst_leaf->GetPageId());
@@ -162,6 +380,8 @@ auto BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *src_leaf, BPlusTreePage *ds
     src_leaf->SetParentPageId(n_root_page->GetPageId());
     dst_leaf->SetParentPageId(n_root_page->GetPageId());
 
+    // the old root is still write-latched, see FetchRootPage()
+    root_page_id_.store(root_page_id);
     buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
 
     UpdateRootPageId(0);
@@ -217,7 +437,7 @@ INDEX_TEMPLATE_ARGUMENTS
 template <typename PageType>
 auto BPLUSTREE_TYPE::SplitBptreePage(PageType *page_to_split) -> PageType * {
   page_id_t page_id{};
-  auto n_bpm_page = buffer_pool_manager_->NewPage(&page_id);
+  auto n_bpm_page = buffer_pool_manager_->NewPageInExtent(&page_id, &extents_);
 
   BUSTUB_ASSERT(n_bpm_page != nullptr, "In SplitLeaf(): buffer_pool_manager_->NewPage failed");
 
@@ -307,8 +527,38 @@ auto BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertOptimistic(const KeyType &key, const ValueType &value) -> std::optional<bool> {
+  auto *page = FindLeafPageOptimistic(key);
+  if (page == nullptr) {
+    // the first key creates the root
+    return std::nullopt;
+  }
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+
+  // the same condition as in FindLeafPage(): a leaf that is not safe may split, which needs the ancestors
+  if (leaf_page->GetSize() >= leaf_max_size_ - 1) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return std::nullopt;
+  }
+
+  auto bf = leaf_page->GetSize();
+  auto aft = leaf_page->Insert(key, value, comparator_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), bf != aft);
+  return bf != aft;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
+  if (optimistic_latching_) {
+    auto inserted = InsertOptimistic(key, value);
+    if (inserted.has_value()) {
+      return *inserted;
+    }
+  }
+
   root_page_latch_.WLock();
   // 将根加入transaction队列
   // root_page_latch_是nullptr
@@ -323,6 +573,96 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   return InsertIntoLeaf(key, value, transaction);
 }
 
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+/*
+ * Build the tree bottom-up from entries instead of inserting them one by one: sort them, pack them into leaves left to
+ * right, then pack the first keys of each level into the internal pages of the level above, until one page is left as
+ * the root. Nodes are filled to fill_factor of their capacity, so later inserts do not split them right away; the
+ * pages come from the extents of the tree in order, so a range scan reads them sequentially.
+ * Of duplicate keys only the first one is kept, like Insert() does. Entries that are already sorted by key, e.g. merged
+ * sorted runs, are not sorted again if sorted is set.
+ * @return false if the tree is not empty, then nothing is loaded
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, double fill_factor, bool sorted)
+    -> bool {
+  // writers of an empty tree always take the pessimistic path, see InsertOptimistic()
+  root_page_latch_.WLock();
+  if (root_page_id_.load() != INVALID_PAGE_ID) {
+    root_page_latch_.WUnlock();
+    return false;
+  }
+  if (entries->empty()) {
+    root_page_latch_.WUnlock();
+    return true;
+  }
+
+  auto less = [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) < 0; };
+  auto equal = [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) == 0; };
+  if (!sorted) {
+    std::stable_sort(entries->begin(), entries->end(), less);
+  }
+  entries->erase(std::unique(entries->begin(), entries->end(), equal), entries->end());
+
+  // a leaf splits once it holds leaf_max_size_ entries, an internal page once it would exceed internal_max_size_
+  auto per_node = [fill_factor](size_t capacity, size_t min_size) {
+    auto size = static_cast<size_t>(std::max(std::lround(fill_factor * static_cast<double>(capacity)), 1L));
+    return std::clamp(size, std::max<size_t>(min_size, 1), capacity);
+  };
+  auto leaf_capacity = static_cast<size_t>(leaf_max_size_ - 1);
+  auto internal_capacity = static_cast<size_t>(internal_max_size_);
+  auto leaf_min_size = static_cast<size_t>(leaf_max_size_ / 2);
+  auto internal_min_size = static_cast<size_t>(std::max((internal_max_size_ + 1) / 2, 2));
+
+  // the first key and the page of every node of the level built last
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  size_t offset = 0;
+  LeafPage *prev_leaf = nullptr;
+  for (auto size : PackNodes(entries->size(), per_node(leaf_capacity, leaf_min_size), leaf_min_size, leaf_capacity)) {
+    page_id_t page_id;
+    auto *page = buffer_pool_manager_->NewPageInExtent(&page_id, &extents_);
+    BUSTUB_ASSERT(page != nullptr, "In BulkLoad(): buffer_pool_manager_->NewPage failed");
+    auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf_page->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+    leaf_page->CopyNToArrBack(entries->data() + offset, static_cast<int>(size));
+    offset += size;
+    if (prev_leaf != nullptr) {
+      prev_leaf->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+    }
+    level.emplace_back(leaf_page->KeyAt(0), page_id);
+    prev_leaf = leaf_page;
+  }
+  buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parent_level;
+    offset = 0;
+    for (auto size : PackNodes(level.size(), per_node(internal_capacity, internal_min_size), internal_min_size,
+                               internal_capacity)) {
+      page_id_t page_id;
+      auto *page = buffer_pool_manager_->NewPageInExtent(&page_id, &extents_);
+      BUSTUB_ASSERT(page != nullptr, "In BulkLoad(): buffer_pool_manager_->NewPage failed");
+      auto *internal_page = reinterpret_cast<InternalPage *>(page->GetData());
+      internal_page->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+      // also sets the parent page id of the children; the first key is not used for lookups
+      internal_page->CopyNToArrBack(level.data() + offset, static_cast<int>(size), buffer_pool_manager_);
+      offset += size;
+      parent_level.emplace_back(internal_page->KeyAt(0), page_id);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+    }
+    level = std::move(parent_level);
+  }
+
+  // publish the root once the tree is complete, like InitNewTree()
+  root_page_id_.store(level[0].second);
+  UpdateRootPageId(1);
+  root_page_latch_.WUnlock();
+  return true;
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -333,8 +673,35 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  * delete entry from leaf page. Remember to deal with redistribute or merge if
  * necessary.
  */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RemoveOptimistic(const KeyType &key) -> bool {
+  auto *page = FindLeafPageOptimistic(key);
+  if (page == nullptr) {
+    return true;
+  }
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+
+  // a leaf that is not safe may need to borrow from or merge with a sibling, or empty the tree
+  bool safe = leaf_page->IsRootPage() ? leaf_page->GetSize() > 1 : leaf_page->GetSize() > leaf_page->GetMinSize();
+  if (!safe) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return false;
+  }
+
+  auto bf = leaf_page->GetSize();
+  auto aft = leaf_page->RemoveArrayRecord(key, comparator_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), bf != aft);
+  return true;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  if (optimistic_latching_ && RemoveOptimistic(key)) {
+    return;
+  }
+
   root_page_latch_.WLock();
   transaction->AddIntoPageSet(nullptr);
 
@@ -571,14 +938,10 @@ void BPLUSTREE_TYPE::Redistribute(PageType *sibling_node, PageType *node_to_redi
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
-  // judge if tree exists
-  if (root_page_id_ == INVALID_PAGE_ID) {
+  auto *page = FindLeafPage(KeyType(), Operation::SEARCH, nullptr, true);
+  if (page == nullptr) {
     return INDEXITERATOR_TYPE(nullptr, nullptr);
   }
-
-  root_page_latch_.RLock();
-
-  auto *page = FindLeafPage(KeyType(), Operation::SEARCH, nullptr, true);
   return INDEXITERATOR_TYPE(buffer_pool_manager_, page, 0);
 }
 
@@ -589,14 +952,10 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
-  // judge if tree exists
-  if (root_page_id_ == INVALID_PAGE_ID) {
+  auto *page = FindLeafPage(key, Operation::SEARCH);
+  if (page == nullptr) {
     return INDEXITERATOR_TYPE(nullptr, nullptr);
   }
-
-  root_page_latch_.RLock();
-
-  auto *page = FindLeafPage(key, Operation::SEARCH);
   auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
 
   auto idx = leaf_page->GetIndex(key, comparator_);
@@ -610,14 +969,10 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
-  // judge if tree exists
-  if (root_page_id_ == INVALID_PAGE_ID) {
+  auto *page = FindLeafPage(KeyType(), Operation::SEARCH, nullptr, false, true);
+  if (page == nullptr) {
     return INDEXITERATOR_TYPE(nullptr, nullptr);
   }
-
-  root_page_latch_.RLock();
-
-  auto *page = FindLeafPage(KeyType(), Operation::SEARCH, nullptr, false, true);
   auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
   return INDEXITERATOR_TYPE(buffer_pool_manager_, page, leaf_page->GetSize());
 }
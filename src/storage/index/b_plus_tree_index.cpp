@@ -11,6 +11,12 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <thread>  // NOLINT
+#include <vector>
+
 namespace bustub {
 /*
  * Constructor
@@ -51,6 +57,63 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, double fill_factor) -> bool {
+  return container_.BulkLoad(entries, fill_factor);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::BuildFromTable(TableHeap *table_heap, const Schema &schema, size_t num_threads,
+                                          Transaction *transaction) -> bool {
+  using Entry = std::pair<KeyType, ValueType>;
+  num_threads = std::max<size_t>(num_threads, 1);
+  // run task(0) ... task(n - 1) at the same time, task(0) on this thread
+  auto run_parallel = [](size_t n, const std::function<void(size_t)> &task) {
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < n; i++) {
+      threads.emplace_back(task, i);
+    }
+    task(0);
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  };
+  // duplicate keys are ordered by RID, so the entry that is kept does not depend on which thread read which page
+  auto less = [this](const Entry &a, const Entry &b) {
+    auto result = comparator_(a.first, b.first);
+    return result < 0 || (result == 0 && a.second.Get() < b.second.Get());
+  };
+
+  std::vector<std::vector<Entry>> runs(num_threads);
+  const bool scanned = table_heap->ParallelScan(num_threads, transaction, [&](size_t thread_index, Tuple &tuple) {
+    KeyType index_key;
+    index_key.SetFromKey(tuple.KeyFromTuple(schema, *GetKeySchema(), GetKeyAttrs()));
+    runs[thread_index].emplace_back(index_key, tuple.GetRid());
+  });
+  if (!scanned) {
+    return false;
+  }
+  run_parallel(runs.size(), [&](size_t i) { std::sort(runs[i].begin(), runs[i].end(), less); });
+
+  while (runs.size() > 1) {
+    std::vector<std::vector<Entry>> merged_runs((runs.size() + 1) / 2);
+    if (runs.size() % 2 == 1) {
+      merged_runs.back() = std::move(runs.back());
+    }
+    run_parallel(runs.size() / 2, [&](size_t i) {
+      auto &left = runs[2 * i];
+      auto &right = runs[2 * i + 1];
+      merged_runs[i].reserve(left.size() + right.size());
+      std::merge(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(merged_runs[i]), less);
+      // free the runs as soon as they are merged
+      std::vector<Entry>().swap(left);
+      std::vector<Entry>().swap(right);
+    });
+    runs = std::move(merged_runs);
+  }
+  return container_.BulkLoad(&runs[0], BULK_LOAD_FILL_FACTOR, true);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return container_.Begin(); }
 
@@ -10,9 +10,17 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/logger.h"
+#include "common/macros.h"
 #include "fmt/format.h"
 #include "storage/table/table_heap.h"
 
@@ -29,11 +37,133 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
                      Transaction *txn)
     : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
   // Initialize the first table page.
-  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
+  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPageInExtent(&first_page_id_, &extents_));
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
   first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  num_pages_ = 1;
+}
+
+TableHeap::~TableHeap() {
+  {
+    std::scoped_lock<std::mutex> lock(read_ahead_latch_);
+    read_ahead_stopped_ = true;
+    read_ahead_requests_.clear();
+    read_ahead_cv_.notify_all();
+  }
+  if (read_ahead_thread_.joinable()) {
+    read_ahead_thread_.join();
+  }
+}
+
+TableReadAhead::~TableReadAhead() { table_heap_->read_ahead_wasted_ += pages_.size(); }
+
+auto TableHeap::GetReadAheadStats() const -> ReadAheadStats {
+  return {pages_read_ahead_, read_ahead_hits_, read_ahead_wasted_};
+}
+
+void TableHeap::OnScanNextPage(std::shared_ptr<TableReadAhead> *read_ahead,
+                               const std::shared_ptr<BufferAccessStrategy> &strategy, page_id_t page_id) {
+  size_t window = std::min<size_t>(read_ahead_window_, buffer_pool_manager_->GetPoolSize() / 8);
+  if (strategy != nullptr) {
+    window = std::min(window, strategy->GetRingSize() / 2);
+  }
+  if (window == 0) {
+    return;
+  }
+  if (*read_ahead == nullptr) {
+    *read_ahead = std::make_shared<TableReadAhead>(this, strategy);
+  }
+
+  auto &state = **read_ahead;
+  size_t num_pages;
+  {
+    std::scoped_lock<std::mutex> lock(state.latch_);
+    state.scan_position_++;
+    // pages the scan has passed were read ahead too late
+    while (!state.pages_.empty() && state.pages_.front().first < state.scan_position_) {
+      state.pages_.pop_front();
+      read_ahead_wasted_++;
+    }
+    if (!state.pages_.empty() && state.pages_.front().first == state.scan_position_) {
+      state.pages_.pop_front();
+      read_ahead_hits_++;
+    }
+
+    if (state.scan_position_ < READ_AHEAD_TRIGGER || state.request_pending_ || state.pages_.size() > window / 2) {
+      return;
+    }
+    // continue after the pages read ahead so far, or right after the scan if it caught up with them
+    if (state.frontier_.second == INVALID_PAGE_ID || state.frontier_.first < state.scan_position_) {
+      state.frontier_ = {state.scan_position_, page_id};
+    }
+    num_pages = window - state.pages_.size();
+    state.request_pending_ = true;
+  }
+
+  std::scoped_lock<std::mutex> lock(read_ahead_latch_);
+  if (!read_ahead_thread_.joinable()) {
+    read_ahead_thread_ = std::thread(&TableHeap::ReadAheadThread, this);
+  }
+  read_ahead_requests_.emplace_back(*read_ahead, num_pages);
+  read_ahead_cv_.notify_one();
+}
+
+void TableHeap::ReadAheadThread() {
+  std::unique_lock<std::mutex> lock(read_ahead_latch_);
+  while (true) {
+    read_ahead_cv_.wait(lock, [&] { return read_ahead_stopped_ || !read_ahead_requests_.empty(); });
+    if (read_ahead_stopped_) {
+      return;
+    }
+    auto [read_ahead, num_pages] = std::move(read_ahead_requests_.front());
+    read_ahead_requests_.pop_front();
+    lock.unlock();
+    ReadAhead(read_ahead, num_pages);
+    // the scan may be gone, then its state dies here
+    read_ahead.reset();
+    lock.lock();
+  }
+}
+
+void TableHeap::ReadAhead(const std::shared_ptr<TableReadAhead> &read_ahead, size_t num_pages) {
+  std::pair<size_t, page_id_t> frontier;
+  {
+    std::scoped_lock<std::mutex> lock(read_ahead->latch_);
+    frontier = read_ahead->frontier_;
+  }
+
+  // the frontier page is only fetched for its next page id, it is resident in the common case
+  for (size_t i = 0; i <= num_pages; i++) {
+    auto page = static_cast<TablePage *>(
+        buffer_pool_manager_->FetchPageReadOnly(frontier.second, read_ahead->strategy_.get()));
+    if (page == nullptr) {
+      break;
+    }
+    page->RLatch();
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(frontier.second, false);
+
+    std::scoped_lock<std::mutex> lock(read_ahead->latch_);
+    if (i > 0) {
+      pages_read_ahead_++;
+      if (frontier.first > read_ahead->scan_position_) {
+        read_ahead->pages_.push_back(frontier);
+      } else {
+        read_ahead_wasted_++;
+      }
+      read_ahead->frontier_ = frontier;
+    }
+    if (next_page_id == INVALID_PAGE_ID || i == num_pages) {
+      break;
+    }
+    frontier = {frontier.first + 1, next_page_id};
+  }
+
+  std::scoped_lock<std::mutex> lock(read_ahead->latch_);
+  read_ahead->request_pending_ = false;
 }
 
 auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
@@ -64,7 +194,7 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
       cur_page = next_page;
     } else {
       // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
+      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPageInExtent(&next_page_id, &extents_));
       // If we could not create a new page,
       if (new_page == nullptr) {
         // Then life sucks and we abort the transaction.
@@ -77,6 +207,9 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
       new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      if (num_pages_ != UNKNOWN_NUM_PAGES) {
+        num_pages_++;
+      }
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
@@ -158,7 +291,7 @@ void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
 
 auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock) -> bool {
   // Find the page which contains the tuple.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPageReadOnly(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
@@ -176,13 +309,15 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
   return res;
 }
 
-auto TableHeap::Begin(Transaction *txn) -> TableIterator {
+auto TableHeap::Begin(Transaction *txn) -> TableIterator { return Begin(txn, nullptr); }
+
+auto TableHeap::Begin(Transaction *txn, std::shared_ptr<BufferAccessStrategy> strategy) -> TableIterator {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
   RID rid;
   auto page_id = first_page_id_;
   while (page_id != INVALID_PAGE_ID) {
-    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPageReadOnly(page_id, strategy.get()));
     page->RLatch();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
     auto found_tuple = page->GetFirstTupleRid(&rid);
@@ -193,9 +328,81 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
     }
     page_id = page->GetNextPageId();
   }
-  return {this, rid, txn};
+  return {this, rid, txn, std::move(strategy)};
 }
 
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
 
+auto TableHeap::ParallelScan(size_t num_threads, Transaction *txn, const std::function<void(size_t, Tuple &)> &visit)
+    -> bool {
+  // each thread pins a page, more threads than free frames would only wait for each other
+  num_threads = std::max<size_t>(std::min(num_threads, buffer_pool_manager_->GetNumFreeFrames()), 1);
+  std::mutex cursor_latch;
+  std::condition_variable unpinned_cv;
+  page_id_t next_page_id = first_page_id_;
+  size_t num_pinned = 0;
+  bool failed = false;
+
+  auto scan = [&](size_t thread_index) {
+    std::vector<Tuple> tuples;
+    while (true) {
+      TablePage *page;
+      {
+        // only the thread holding the cursor may follow the chain
+        std::unique_lock<std::mutex> lock(cursor_latch);
+        while (true) {
+          if (next_page_id == INVALID_PAGE_ID || failed) {
+            return;
+          }
+          page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+          if (page != nullptr) {
+            break;
+          }
+          if (num_pinned == 0) {
+            // all frames are pinned by someone else, there is no telling when one becomes free
+            failed = true;
+            unpinned_cv.notify_all();
+            return;
+          }
+          unpinned_cv.wait(lock);
+        }
+        num_pinned++;
+        page->RLatch();
+        next_page_id = page->GetNextPageId();
+      }
+
+      // copy the tuples out, so the page is not latched while they are visited
+      tuples.clear();
+      RID rid;
+      for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(rid, &rid)) {
+        tuples.emplace_back(rid);
+        if (!page->GetTuple(rid, &tuples.back(), txn, lock_manager_)) {
+          tuples.pop_back();
+        }
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+      {
+        std::scoped_lock<std::mutex> lock(cursor_latch);
+        num_pinned--;
+      }
+      unpinned_cv.notify_all();
+
+      for (auto &tuple : tuples) {
+        visit(thread_index, tuple);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(scan, i);
+  }
+  scan(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return !failed;
+}
+
 }  // namespace bustub
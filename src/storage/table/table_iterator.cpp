@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <utility>
 
 #include "common/exception.h"
 #include "concurrency/transaction.h"
@@ -18,9 +19,11 @@
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn,
+                             std::shared_ptr<BufferAccessStrategy> strategy)
+    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn), strategy_(std::move(strategy)) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
+    AdviseScanRange(rid.GetPageId());
     if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_)) {
       throw bustub::Exception("read non-existing tuple");
     }
@@ -43,7 +46,7 @@ auto TableIterator::operator++() -> TableIterator & {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
 
   // tuple_->rid_.GetPageId() tuple_是TableIterator成员变量,是利用page拿的rid初始化的空tuple
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPageReadOnly(tuple_->rid_.GetPageId()));
   BUSTUB_ENSURE(cur_page != nullptr, "BPM full");  // all pages are pinned
 
   cur_page->RLatch();
@@ -52,7 +55,11 @@ auto TableIterator::operator++() -> TableIterator & {
                                  &next_tuple_rid)) {  // end of this page
     // 意思是可能tuple比较大，一张page没存下，当前page跑到末尾，需要再拿 下一个page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
+      auto next_page_id = cur_page->GetNextPageId();
+      auto next_page =
+          static_cast<TablePage *>(buffer_pool_manager->FetchPageReadOnly(next_page_id, strategy_.get()));
+      table_heap_->OnScanNextPage(&read_ahead_, strategy_, next_page_id);
+      AdviseScanRange(next_page_id);
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       cur_page = next_page;
@@ -63,6 +70,9 @@ auto TableIterator::operator++() -> TableIterator & {
     }
   }
   tuple_->rid_ = next_tuple_rid;
+  if (tuple_->rid_.GetPageId() == INVALID_PAGE_ID) {
+    AdviseScanRange(INVALID_PAGE_ID);
+  }
 
   if (*this != table_heap_->End()) {
     // DO NOT ACQUIRE READ LOCK twice in a single thread otherwise it may deadlock.
@@ -79,6 +89,24 @@ auto TableIterator::operator++() -> TableIterator & {
   return *this;
 }
 
+void TableIterator::AdviseScanRange(page_id_t page_id) {
+  if (strategy_ == nullptr) {
+    return;
+  }
+  page_id_t extent = page_id == INVALID_PAGE_ID ? INVALID_PAGE_ID : page_id / BUSTUB_EXTENT_SIZE * BUSTUB_EXTENT_SIZE;
+  if (extent == advised_extent_) {
+    return;
+  }
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  if (advised_extent_ != INVALID_PAGE_ID) {
+    buffer_pool_manager->AdviseAccessPattern(advised_extent_, BUSTUB_EXTENT_SIZE, AccessPattern::NORMAL);
+  }
+  if (extent != INVALID_PAGE_ID) {
+    buffer_pool_manager->AdviseAccessPattern(extent, BUSTUB_EXTENT_SIZE, AccessPattern::SEQUENTIAL);
+  }
+  advised_extent_ = extent;
+}
+
 // 迭代器++
 auto TableIterator::operator++(int) -> TableIterator {
   TableIterator clone(*this);
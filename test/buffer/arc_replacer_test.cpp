@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer_test.cpp
+//
+// Identification: test/buffer/arc_replacer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ArcReplacerTest, SampleTest) {
+  ArcReplacer arc_replacer(4);
+
+  // Scenario: load pages 10, 11, 12, 13 into frames 0-3 and unpin them. All of them are in T1.
+  for (frame_id_t i = 0; i < 4; i++) {
+    arc_replacer.RecordAccess(i, 10 + i);
+    arc_replacer.SetEvictable(i, true);
+  }
+  ASSERT_EQ(4, arc_replacer.Size());
+
+  // Scenario: hit frames 0 and 1 again. Pages 10 and 11 move to T2.
+  arc_replacer.RecordAccess(0, 10);
+  arc_replacer.RecordAccess(1, 11);
+
+  // Scenario: T1 is larger than its target size (0), so the LRU page of T1 goes first, and is remembered in B1.
+  int value;
+  ASSERT_EQ(true, arc_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ(3, arc_replacer.Size());
+
+  // Scenario: page 12 comes back into frame 2. It was evicted too early, so T1's target grows and 12 enters T2.
+  arc_replacer.RecordAccess(2, 12);
+  arc_replacer.SetEvictable(2, true);
+
+  // Scenario: T1 (page 13) is now within its target of 1, so the LRU page of T2 (10) is evicted instead.
+  ASSERT_EQ(true, arc_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+
+  // Scenario: pinned frames are skipped; frame 3 is the only evictable frame of T1 but T1 is at its target, so
+  // T2 is preferred, and once T2 only holds pinned frames, T1 is used anyway.
+  arc_replacer.SetEvictable(1, false);
+  arc_replacer.SetEvictable(2, false);
+  ASSERT_EQ(1, arc_replacer.Size());
+  ASSERT_EQ(true, arc_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+  ASSERT_EQ(false, arc_replacer.Evict(&value));
+
+  // Scenario: removed frames are forgotten.
+  arc_replacer.SetEvictable(1, true);
+  arc_replacer.Remove(1);
+  ASSERT_EQ(0, arc_replacer.Size());
+  arc_replacer.Remove(1);
+  ASSERT_EQ(0, arc_replacer.Size());
+}
+
+TEST(ArcReplacerTest, ScanResistanceTest) {
+  const frame_id_t num_frames = 8;
+  ArcReplacer arc_replacer(num_frames);
+
+  // Scenario: frames 0-3 hold a hot working set that has been accessed twice.
+  for (frame_id_t i = 0; i < 4; i++) {
+    arc_replacer.RecordAccess(i, i);
+    arc_replacer.RecordAccess(i, i);
+    arc_replacer.SetEvictable(i, true);
+  }
+
+  // Scenario: a long scan streams pages 100.. through the remaining frames. Each scanned page is seen once.
+  for (frame_id_t i = 4; i < num_frames; i++) {
+    arc_replacer.RecordAccess(i, 100 + i);
+    arc_replacer.SetEvictable(i, true);
+  }
+  for (page_id_t page_id = 200; page_id < 300; page_id++) {
+    int victim;
+    ASSERT_EQ(true, arc_replacer.Evict(&victim));
+    // the scan only ever recycles its own frames
+    ASSERT_GE(victim, 4);
+    arc_replacer.RecordAccess(victim, page_id);
+    arc_replacer.SetEvictable(victim, true);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,182 @@
+/**
+ * buffer_pool_manager_benchmark_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_simulated.h"
+
+namespace bustub {
+
+// Average latency in nanoseconds of a FetchPage miss in a pool where all but `num_evictable` frames are pinned.
+auto BufferPoolMissLatencyCall(size_t pool_size, size_t num_evictable, size_t num_misses) -> double {
+  const size_t num_cold_pages = 4 * num_evictable;
+  auto *disk_manager = new DiskManagerMemory(pool_size + num_cold_pages);
+  auto *bpm = new BufferPoolManagerInstance(pool_size, disk_manager, 2);
+
+  // create every page once, the first `num_cold_pages` of them end up evicted
+  page_id_t page_id;
+  for (size_t i = 0; i < pool_size + num_cold_pages; i++) {
+    bpm->NewPage(&page_id);
+    bpm->UnpinPage(page_id, false);
+  }
+  // pin everything that is resident except `num_evictable` frames
+  for (size_t i = num_cold_pages + num_evictable; i < pool_size + num_cold_pages; i++) {
+    bpm->FetchPage(static_cast<page_id_t>(i));
+  }
+
+  // cycling over more cold pages than evictable frames makes every fetch a miss
+  auto clock_start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_misses; i++) {
+    auto cold_page_id = static_cast<page_id_t>(i % num_cold_pages);
+    EXPECT_NE(nullptr, bpm->FetchPage(cold_page_id));
+    bpm->UnpinPage(cold_page_id, false);
+  }
+  auto clock_end = std::chrono::steady_clock::now();
+
+  delete bpm;
+  delete disk_manager;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_end - clock_start).count()) /
+         num_misses;
+}
+
+TEST(BufferPoolManagerBenchmarkTest, LargePoolMissLatency) {  // NOLINT
+  std::vector<size_t> pool_sizes{1 << 10, 1 << 12, 1 << 14};
+  std::vector<double> latency_ns;
+  for (auto pool_size : pool_sizes) {
+    latency_ns.push_back(BufferPoolMissLatencyCall(pool_size, 4, 20000));
+  }
+  std::cout << "This test will see how the miss latency of the buffer pool changes with its size." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t i = 0; i < pool_sizes.size(); i++) {
+    std::cout << "Pool Size: " << pool_sizes[i] << " Miss Latency: " << latency_ns[i] << " ns" << std::endl;
+  }
+  std::cout << "Ratio: " << latency_ns.back() / latency_ns.front() << std::endl;
+  std::cout << ">>> END" << std::endl;
+}
+
+// Counts the page reads that reach the disk, i.e. the buffer pool misses.
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    num_reads_++;
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+  size_t num_reads_{0};
+};
+
+// Hit ratio of a mixed workload: skewed point accesses to a hot set, interleaved with full scans of a table that is
+// larger than the buffer pool.
+auto BufferPoolHitRatioCall(ReplacerType replacer_type, size_t pool_size, size_t num_rounds) -> double {
+  const size_t num_hot_pages = pool_size / 2;
+  const size_t num_scan_pages = pool_size * 2;
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(pool_size, disk_manager, 2, nullptr, replacer_type);
+
+  page_id_t page_id;
+  for (size_t i = 0; i < num_hot_pages + num_scan_pages; i++) {
+    bpm->NewPage(&page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+
+  std::default_random_engine rng(15445);
+  std::uniform_int_distribution<page_id_t> hot_dist(0, num_hot_pages - 1);
+  size_t num_fetches = 0;
+  disk_manager->num_reads_ = 0;
+  for (size_t round = 0; round < num_rounds; round++) {
+    // OLTP: point accesses to the hot pages
+    for (size_t i = 0; i < pool_size * 4; i++) {
+      page_id = hot_dist(rng);
+      bpm->FetchPage(page_id);
+      bpm->UnpinPage(page_id, false);
+      num_fetches++;
+    }
+    // reporting: one sequential scan
+    for (size_t i = num_hot_pages; i < num_hot_pages + num_scan_pages; i++) {
+      page_id = static_cast<page_id_t>(i);
+      bpm->FetchPage(page_id);
+      bpm->UnpinPage(page_id, false);
+      num_fetches++;
+    }
+  }
+
+  auto hit_ratio = 1.0 - static_cast<double>(disk_manager->num_reads_) / num_fetches;
+  delete bpm;
+  delete disk_manager;
+  return hit_ratio;
+}
+
+TEST(BufferPoolManagerBenchmarkTest, ReplacerHitRatio) {  // NOLINT
+  std::vector<std::pair<std::string, ReplacerType>> replacer_types{{"LRU-K", ReplacerType::LRUK},
+                                                                   {"LRU", ReplacerType::LRU},
+                                                                   {"CLOCK", ReplacerType::CLOCK},
+                                                                   {"ARC", ReplacerType::ARC},
+                                                                   {"2Q", ReplacerType::TWO_QUEUE}};
+  std::cout << "This test will see how each replacement policy copes with scans mixed into a skewed workload."
+            << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (const auto &[name, replacer_type] : replacer_types) {
+    std::cout << "Replacer: " << name << " Hit Ratio: " << BufferPoolHitRatioCall(replacer_type, 256, 20)
+              << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+// Time in milliseconds to write back `num_pages` dirty pages on a simulated device, page by page in random order, as
+// evictions would, or in one batch.
+auto BufferPoolFlushTimeCall(const DeviceModel &model, size_t num_pages, bool flush_all) -> double {
+  auto *disk_manager = new SimulatedDiskManager(model);
+  auto *bpm = new BufferPoolManagerInstance(num_pages, disk_manager, 2);
+
+  page_id_t page_id;
+  for (size_t i = 0; i < num_pages; i++) {
+    bpm->NewPage(&page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+
+  auto clock_start = std::chrono::steady_clock::now();
+  if (flush_all) {
+    bpm->FlushAllPages();
+  } else {
+    std::vector<page_id_t> page_ids(num_pages);
+    std::iota(page_ids.begin(), page_ids.end(), 0);
+    std::shuffle(page_ids.begin(), page_ids.end(), std::default_random_engine(15445));
+    for (auto flushed_page_id : page_ids) {
+      bpm->FlushPage(flushed_page_id);
+    }
+  }
+  auto clock_end = std::chrono::steady_clock::now();
+  EXPECT_EQ(num_pages, disk_manager->GetNumWrites());
+
+  delete bpm;
+  delete disk_manager;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(clock_end - clock_start).count()) /
+         1000;
+}
+
+TEST(BufferPoolManagerBenchmarkTest, SimulatedDeviceFlushTime) {  // NOLINT
+  std::vector<std::pair<std::string, DeviceModel>> devices{{"SSD", DeviceModel::Ssd()}, {"HDD", DeviceModel::Hdd()}};
+  std::cout << "This test will see how much batching the write-back of dirty pages hides the device latency."
+            << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (const auto &[name, model] : devices) {
+    auto page_by_page_ms = BufferPoolFlushTimeCall(model, 64, false);
+    auto flush_all_ms = BufferPoolFlushTimeCall(model, 64, true);
+    std::cout << "Device: " << name << " FlushPage: " << page_by_page_ms << " ms FlushAllPages: " << flush_all_ms
+              << " ms" << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
@@ -12,12 +12,22 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <random>
+#include <set>
+#include <sstream>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/bustub_instance.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_posix.h"
 
 namespace bustub {
 
@@ -145,4 +155,640 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+// Check that pages survive eviction while other threads hit and miss on the same frames
+TEST(BufferPoolManagerInstanceTest, ConcurrentEvictionTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_pages = 16;
+  const size_t num_threads = 4;
+  const size_t k = 2;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  for (size_t i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: threads keep evicting dirty pages from each other's feet. Every successful fetch must see the
+  // content of the page it asked for, never a stale or half-loaded frame.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([bpm, t]() {
+      std::default_random_engine rng(t);
+      std::uniform_int_distribution<page_id_t> page_dist(0, num_pages - 1);
+      for (int iter = 0; iter < 500; iter++) {
+        page_id_t page_id = page_dist(rng);
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+        bpm->UnpinPage(page_id, iter % 2 == 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// Check that every replacement policy can be plugged into the buffer pool
+TEST(BufferPoolManagerInstanceTest, ReplacerPolicyTest) {
+  const size_t buffer_pool_size = 10;
+
+  for (auto replacer_type :
+       {ReplacerType::LRUK, ReplacerType::LRU, ReplacerType::CLOCK, ReplacerType::ARC, ReplacerType::TWO_QUEUE}) {
+    auto *disk_manager = new DiskManagerUnlimitedMemory();
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2, nullptr, replacer_type);
+
+    // Scenario: fill the buffer pool, it is then full of pinned pages.
+    page_id_t page_id_temp;
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    }
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+    // Scenario: unpinning half of the pages lets exactly that many new pages in.
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_EQ(true, bpm->UnpinPage(i, true));
+    }
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+    }
+
+    // Scenario: evicted dirty pages were written back and can be fetched again.
+    for (int i = 0; i < 5; ++i) {
+      auto *page = bpm->FetchPage(i);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::to_string(i), std::string(page->GetData()));
+      EXPECT_EQ(true, bpm->UnpinPage(i, false));
+    }
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// Counts the page reads and writes that reach the disk.
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    num_reads_++;
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+  auto WritePage(page_id_t page_id, const char *page_data) -> bool override {
+    num_writes_++;
+    return DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+  auto WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) -> bool override {
+    num_runs_++;
+    return DiskManagerUnlimitedMemory::WritePages(first_page_id, pages, num_pages);
+  }
+  std::atomic<size_t> num_reads_{0};
+  std::atomic<size_t> num_writes_{0};
+  std::atomic<size_t> num_runs_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BackgroundWriterTest) {
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+
+  // Scenario: fill the buffer pool with dirty, unpinned pages.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  EXPECT_EQ(0, disk_manager->num_writes_);
+
+  // Scenario: the background writer cleans the next victims, at most 4 per round.
+  BackgroundWriterOptions options;
+  options.interval_ = std::chrono::milliseconds(1);
+  options.max_pages_per_round_ = 4;
+  bpm->RunBackgroundWriter(options);
+  while (disk_manager->num_writes_ < buffer_pool_size) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bpm->StopBackgroundWriter();
+  EXPECT_EQ(buffer_pool_size, disk_manager->num_writes_);
+
+  // Scenario: misses now find clean victims and do not write anything.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(buffer_pool_size, disk_manager->num_writes_);
+
+  // Scenario: the written pages can be read back.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(i), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(i, false));
+  }
+
+  // Scenario: a dirty ratio threshold keeps the writer idle.
+  for (page_id_t i = 0; i < 3; ++i) {
+    bpm->FetchPage(i);
+    EXPECT_EQ(true, bpm->UnpinPage(i, true));
+  }
+  options.dirty_ratio_threshold_ = 0.5;
+  bpm->RunBackgroundWriter(options);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  delete bpm;
+  EXPECT_EQ(buffer_pool_size, disk_manager->num_writes_);
+
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, FlushAllOrderTest) {
+  const size_t buffer_pool_size = 2 * FLUSH_CHUNK_SIZE;
+
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+
+  // Scenario: the pages end up in the frames out of order, the frames of even pages come first on the free list.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  for (page_id_t first : {0, 1}) {
+    for (page_id_t i = first; i < static_cast<page_id_t>(buffer_pool_size); i += 2) {
+      EXPECT_EQ(true, bpm->DeletePage(i));
+    }
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: the dirty pages of the whole pool are sorted, so every chunk is a single run of adjacent pages.
+  bpm->FlushAllPages();
+  EXPECT_EQ(buffer_pool_size, disk_manager->num_writes_);
+  EXPECT_EQ(2, disk_manager->num_runs_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+/** Fails every asynchronous write, like a full disk would. */
+class FailingAsyncDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  auto WritePageAsync(page_id_t page_id, const char *page_data) -> DiskRequest override { return DiskRequest(false); }
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BackgroundWriterFailureTest) {
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new FailingAsyncDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: the pages of failed writes stay dirty and are not counted as written back.
+  BackgroundWriterOptions options;
+  options.interval_ = std::chrono::milliseconds(1);
+  bpm->RunBackgroundWriter(options);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  bpm->StopBackgroundWriter();
+  EXPECT_EQ(0, bpm->GetStats()[0].writebacks_);
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_TRUE(page->IsDirty());
+    EXPECT_EQ(true, bpm->UnpinPage(i, false));
+  }
+
+  // Scenario: a failed FlushPage() reports the failure and keeps the page dirty as well.
+  EXPECT_FALSE(bpm->FlushPage(0));
+  auto *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(page->IsDirty());
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  EXPECT_EQ(0, bpm->GetStats()[0].flushes_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, FailedFlushTest) {
+  const size_t buffer_pool_size = 4;
+  remove("test.db");
+  remove("test.fsm");
+  remove("test.ext");
+
+  auto *disk_manager = new PosixDiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  EXPECT_TRUE(bpm->FlushPage(0));
+
+  // Scenario: once the database file is gone, the writes of a real disk manager fail and the pages stay dirty.
+  disk_manager->ShutDown();
+  EXPECT_FALSE(bpm->FlushPage(1));
+  BackgroundWriterOptions options;
+  options.interval_ = std::chrono::milliseconds(1);
+  bpm->RunBackgroundWriter(options);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  bpm->StopBackgroundWriter();
+  EXPECT_EQ(0, bpm->GetStats()[0].writebacks_);
+  EXPECT_EQ(1, bpm->GetStats()[0].flushes_);
+  for (page_id_t i = 1; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_TRUE(page->IsDirty());
+    EXPECT_EQ(true, bpm->UnpinPage(i, false));
+  }
+
+  // Scenario: evicting a dirty page whose write fails is not counted as a writeback. The fetch that needed the frame
+  // fails, and the evicted page stays in the pool and dirty.
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  EXPECT_EQ(nullptr, bpm->FetchPage(buffer_pool_size));
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, bpm->GetStats()[0].writebacks_);
+  EXPECT_EQ(buffer_pool_size, bpm->GetNumFreeFrames());
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(i, page->GetPageId());
+    EXPECT_TRUE(page->IsDirty());
+    EXPECT_EQ(true, bpm->UnpinPage(i, false));
+  }
+  EXPECT_EQ(1, bpm->GetStats()[0].misses_);
+
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.fsm");
+  remove("test.ext");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BufferAccessStrategyTest) {
+  const size_t buffer_pool_size = 10;
+  const page_id_t num_cold_pages = 20;
+  const page_id_t num_hot_pages = 5;
+
+  for (bool use_strategy : {false, true}) {
+    auto *disk_manager = new CountingDiskManager();
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2, nullptr, ReplacerType::LRU);
+    auto strategy = std::make_unique<BufferAccessStrategy>(2);
+
+    // Scenario: a table of cold pages on disk, then a hot working set in the buffer pool.
+    page_id_t page_id_temp;
+    for (page_id_t i = 0; i < num_cold_pages + num_hot_pages; ++i) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+
+    // Scenario: scan the cold pages.
+    for (page_id_t i = 0; i < num_cold_pages; ++i) {
+      auto *page = use_strategy ? bpm->FetchPageWithStrategy(i, strategy.get()) : bpm->FetchPage(i);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(true, bpm->UnpinPage(i, false));
+    }
+
+    // Scenario: with a ring, the scan only recycled its own frames and the hot pages are all still in the pool.
+    size_t num_reads = disk_manager->num_reads_;
+    for (page_id_t i = num_cold_pages; i < num_cold_pages + num_hot_pages; ++i) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i));
+      EXPECT_EQ(true, bpm->UnpinPage(i, false));
+    }
+    if (use_strategy) {
+      EXPECT_EQ(num_reads, disk_manager->num_reads_);
+    } else {
+      EXPECT_EQ(num_reads + num_hot_pages, disk_manager->num_reads_);
+    }
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, DirectIoTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  const int num_pages = 32;
+
+  auto *disk_manager = new PosixDiskManager(db_name, true);
+  for (bool use_huge_pages : {false, true}) {
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2, nullptr, ReplacerType::LRUK,
+                                              use_huge_pages);
+    // every frame can be handed to the device without a bounce buffer
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(bpm->GetPages()[i].GetData()) % BUSTUB_PAGE_SIZE);
+      EXPECT_EQ(0, bpm->GetPages()[i].GetData()[BUSTUB_PAGE_SIZE - 1]);
+    }
+
+    // more pages than frames, so the pages go to disk and come back from it
+    std::vector<page_id_t> page_ids;
+    for (int i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", i);
+      page_ids.push_back(page_id);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    for (int i = 0; i < num_pages; i++) {
+      auto *page = bpm->FetchPage(page_ids[i]);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+    }
+    delete bpm;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, MappedPageWriteTest) {
+  const std::string db_name = "test.db";
+  const int num_pages = 2;
+
+  auto *disk_manager = new PosixDiskManager(db_name);
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  for (int i = 0; i < num_pages; i++) {
+    snprintf(data, BUSTUB_PAGE_SIZE, "page %d", i);
+    disk_manager->WritePage(i, data);
+  }
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  // a single frame, so the modified page is evicted and fetched again
+  auto *mmap_disk_manager = new MmapDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(1, mmap_disk_manager);
+  const char *mapped_page = mmap_disk_manager->GetMappedPage(0);
+
+  // Scenario: read-only fetches use the mapped page in place, a fetch that may modify the page gets a copy in the frame.
+  auto *page = bpm->FetchPageReadOnly(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(mapped_page, page->GetData());
+  const char *read_data = page->GetData();
+  page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_NE(mapped_page, page->GetData());
+  EXPECT_EQ("page 0", std::string(page->GetData()));
+  snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "modified");
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  // the change is not in the file before the page is written back
+  EXPECT_EQ("page 0", std::string(read_data));
+  EXPECT_EQ("page 0", std::string(mapped_page));
+
+  page = bpm->FetchPageReadOnly(1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page 1", std::string(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+  EXPECT_EQ("modified", std::string(mapped_page));
+  page = bpm->FetchPageReadOnly(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(mapped_page, page->GetData());
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  // a page created after the file was mapped is written to the file when it is evicted, and read back from it
+  page_id_t page_id;
+  page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(nullptr, mmap_disk_manager->GetMappedPage(page_id));
+  snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "new page");
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("new page", std::string(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  EXPECT_TRUE(bpm->FlushPage(page_id));
+
+  delete bpm;
+  mmap_disk_manager->ShutDown();
+  delete mmap_disk_manager;
+
+  // the changes reached the file
+  disk_manager = new PosixDiskManager(db_name);
+  disk_manager->ReadPage(0, data);
+  EXPECT_EQ("modified", std::string(data));
+  disk_manager->ReadPage(page_id, data);
+  EXPECT_EQ("new page", std::string(data));
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove("test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PageReuseTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(2, disk_manager, 2);
+
+  page_id_t page_id;
+  for (page_id_t expected = 0; expected < 4; expected++) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(expected, page_id);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // deleted pages are handed out again, the one closest to the hint first, resident or not
+  EXPECT_TRUE(bpm->DeletePage(0));
+  EXPECT_TRUE(bpm->DeletePage(2));
+  EXPECT_EQ(2, disk_manager->GetNumFreePages());
+  // an invalid id or one that was never handed out does not become a free page
+  EXPECT_TRUE(bpm->DeletePage(INVALID_PAGE_ID));
+  EXPECT_TRUE(bpm->DeletePage(10 * BUSTUB_EXTENT_SIZE));
+  EXPECT_EQ(2, disk_manager->GetNumFreePages());
+  auto *page = bpm->NewPageNear(&page_id, 3);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(2, page_id);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(0, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(4, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // the reused pages were never dirtied by the caller, still their old contents are gone from disk
+  for (page_id_t reused : {0, 2}) {
+    page = bpm->FetchPage(reused);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, page->GetData()[0]);
+    EXPECT_TRUE(bpm->UnpinPage(reused, false));
+  }
+  page = bpm->FetchPage(3);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(std::string("page 3"), page->GetData());
+  EXPECT_TRUE(bpm->UnpinPage(3, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, DeleteUnallocatedPageTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(2, disk_manager, 2);
+
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(0, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // pages of the current extent that were never handed out, and a page deleted twice, do not become free pages
+  EXPECT_TRUE(bpm->DeletePage(5));
+  EXPECT_TRUE(bpm->DeletePage(BUSTUB_EXTENT_SIZE - 1));
+  EXPECT_EQ(0, disk_manager->GetNumFreePages());
+  EXPECT_TRUE(bpm->DeletePage(0));
+  EXPECT_TRUE(bpm->DeletePage(0));
+  EXPECT_EQ(1, disk_manager->GetNumFreePages());
+
+  // no page id is handed out twice, neither by the free pages, the new pages nor the extents
+  ExtentAllocator index;
+  std::set<page_id_t> page_ids;
+  for (int i = 0; i < 2 * BUSTUB_EXTENT_SIZE; i++) {
+    ASSERT_NE(nullptr, i % 2 == 0 ? bpm->NewPage(&page_id) : bpm->NewPageInExtent(&page_id, &index));
+    EXPECT_TRUE(page_ids.insert(page_id).second) << "page " << page_id << " was handed out twice";
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ExtentTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(2, disk_manager, 2);
+
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(0, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // pages of an extent that was deallocated as a whole are dirty right away, like other reused pages
+  ExtentAllocator index;
+  std::vector<page_id_t> index_pages;
+  for (int i = 0; i < BUSTUB_EXTENT_SIZE; i++) {
+    auto *page = bpm->NewPageInExtent(&page_id, &index);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(BUSTUB_EXTENT_SIZE + i, page_id);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    index_pages.push_back(page_id);
+  }
+  for (auto index_page : index_pages) {
+    EXPECT_TRUE(bpm->DeletePage(index_page));
+  }
+  ExtentAllocator table;
+  auto *page = bpm->NewPageInExtent(&page_id, &table);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(BUSTUB_EXTENT_SIZE, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(1, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  page = bpm->FetchPage(BUSTUB_EXTENT_SIZE);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_TRUE(bpm->UnpinPage(BUSTUB_EXTENT_SIZE, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, StatsTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(2, disk_manager, 2);
+
+  page_id_t page_id;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  // page 0 was evicted and written back to make room for page 2
+  ASSERT_NE(nullptr, bpm->FetchPage(2));
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_EQ(nullptr, bpm->FetchPage(1));
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+  EXPECT_TRUE(bpm->FlushPage(2));
+
+  auto stats = bpm->GetStats();
+  ASSERT_EQ(1, stats.size());
+  EXPECT_EQ(0, stats[0].instance_index_);
+  EXPECT_EQ(1, stats[0].hits_);
+  EXPECT_EQ(2, stats[0].misses_);
+  EXPECT_DOUBLE_EQ(1.0 / 3, stats[0].GetHitRatio());
+  EXPECT_EQ(2, stats[0].evictions_);
+  EXPECT_EQ(2, stats[0].writebacks_);
+  EXPECT_EQ(1, stats[0].flushes_);
+  EXPECT_EQ(2, stats[0].pin_failures_);
+  uint64_t fetches = 0;
+  for (auto count : stats[0].fetch_latency_) {
+    fetches += count;
+  }
+  EXPECT_EQ(3, fetches);
+  EXPECT_LE(stats[0].GetFetchLatencyPercentile(0.5), stats[0].GetFetchLatencyPercentile(0.99));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, StatsSystemTableTest) {
+  BustubInstance bustub;
+  bustub.GenerateMockTable();
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bustub.buffer_pool_manager_->NewPage(&page_id));
+  ASSERT_NE(nullptr, bustub.buffer_pool_manager_->FetchPage(page_id));
+
+  std::stringstream ss;
+  auto writer = SimpleStreamWriter(ss, true);
+  bustub.ExecuteSql("SELECT instance, hits, misses, pin_failures FROM __buffer_pool_stats", writer);
+  EXPECT_EQ("0\t1\t0\t0\t\n", ss.str());
+
+  // one row per latency bucket that has fetches
+  ss.str("");
+  bustub.ExecuteSql("SELECT instance, fetches FROM __buffer_pool_fetch_latency", writer);
+  EXPECT_EQ("0\t1\t\n", ss.str());
+}
+
 }  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdio>
 #include <thread>  // NOLINT
 #include <vector>
@@ -19,44 +20,88 @@
 
 namespace bustub {
 
-TEST(ClockReplacerTest, DISABLED_SampleTest) {
+TEST(ClockReplacerTest, SampleTest) {
   ClockReplacer clock_replacer(7);
 
-  // Scenario: unpin six elements, i.e. add them to the replacer.
-  clock_replacer.Unpin(1);
-  clock_replacer.Unpin(2);
-  clock_replacer.Unpin(3);
-  clock_replacer.Unpin(4);
-  clock_replacer.Unpin(5);
-  clock_replacer.Unpin(6);
-  clock_replacer.Unpin(1);
+  // Scenario: access and unpin six elements, i.e. add them to the replacer.
+  for (frame_id_t i = 1; i <= 6; i++) {
+    clock_replacer.RecordAccess(i, i);
+    clock_replacer.SetEvictable(i, true);
+  }
+  clock_replacer.SetEvictable(1, true);
   EXPECT_EQ(6, clock_replacer.Size());
 
   // Scenario: get three victims from the clock.
   int value;
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(1, value);
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(2, value);
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(3, value);
 
   // Scenario: pin elements in the replacer.
   // Note that 3 has already been victimized, so pinning 3 should have no effect.
-  clock_replacer.Pin(3);
-  clock_replacer.Pin(4);
+  clock_replacer.SetEvictable(3, false);
+  clock_replacer.SetEvictable(4, false);
   EXPECT_EQ(2, clock_replacer.Size());
 
   // Scenario: unpin 4. We expect that the reference bit of 4 will be set to 1.
-  clock_replacer.Unpin(4);
+  clock_replacer.RecordAccess(4, 4);
+  clock_replacer.SetEvictable(4, true);
 
   // Scenario: continue looking for victims. We expect these victims.
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(5, value);
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(6, value);
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(4, value);
 }
 
+TEST(ClockReplacerTest, ConcurrencyTest) {
+  const size_t num_frames = 64;
+  const int num_threads = 4;
+  ClockReplacer clock_replacer(num_frames);
+
+  // Scenario: every frame is tracked and evictable.
+  for (frame_id_t i = 0; i < static_cast<frame_id_t>(num_frames); i++) {
+    clock_replacer.RecordAccess(i, i);
+    clock_replacer.SetEvictable(i, true);
+  }
+
+  // Scenario: threads hit frames while other threads evict. Every frame is handed out exactly once.
+  std::vector<std::vector<frame_id_t>> victims(num_threads);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&clock_replacer, &victims, tid]() {
+      frame_id_t frame_id;
+      for (frame_id_t i = 0; i < static_cast<frame_id_t>(num_frames); i++) {
+        clock_replacer.RecordAccess(i, i);
+        if (clock_replacer.Evict(&frame_id)) {
+          victims[tid].push_back(frame_id);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  frame_id_t frame_id;
+  std::vector<frame_id_t> all_victims;
+  while (clock_replacer.Evict(&frame_id)) {
+    all_victims.push_back(frame_id);
+  }
+  for (const auto &thread_victims : victims) {
+    all_victims.insert(all_victims.end(), thread_victims.begin(), thread_victims.end());
+  }
+  std::sort(all_victims.begin(), all_victims.end());
+  ASSERT_EQ(num_frames, all_victims.size());
+  for (frame_id_t i = 0; i < static_cast<frame_id_t>(num_frames); i++) {
+    EXPECT_EQ(i, all_victims[i]);
+  }
+  EXPECT_EQ(0, clock_replacer.Size());
+}
+
 }  // namespace bustub
@@ -0,0 +1,120 @@
+/**
+ * lru_k_replacer_benchmark_test.cpp
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <list>
+#include <mutex>  // NOLINT
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/**
+ * The previous list-based replacer, kept as the baseline: a history list of frames with fewer than k accesses and a
+ * cache list ordered by latest access, both scanned from the tail for an evictable frame.
+ */
+class ListLRUKReplacer {
+ public:
+  ListLRUKReplacer(size_t num_frames, size_t k) : k_(k) {}
+
+  auto Evict(frame_id_t *frame_id) -> bool {
+    std::scoped_lock<std::mutex> lock(latch_);
+    for (auto *list : {&history_list_, &cache_list_}) {
+      for (auto it = list->rbegin(); it != list->rend(); it++) {
+        if (data_[*it].evictable_) {
+          *frame_id = *it;
+          list->erase(std::next(it).base());
+          data_.erase(*frame_id);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void RecordAccess(frame_id_t frame_id) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto &frame = data_[frame_id];
+    auto new_cnt = ++frame.use_count_;
+    if (new_cnt == 1) {
+      history_list_.emplace_front(frame_id);
+      frame.pos_ = history_list_.begin();
+    } else if (new_cnt >= k_) {
+      (new_cnt == k_ ? history_list_ : cache_list_).erase(frame.pos_);
+      cache_list_.emplace_front(frame_id);
+      frame.pos_ = cache_list_.begin();
+    }
+  }
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (data_.count(frame_id) != 0) {
+      data_[frame_id].evictable_ = set_evictable;
+    }
+  }
+
+ private:
+  struct MapFrame {
+    bool evictable_{false};
+    size_t use_count_{0};
+    std::list<frame_id_t>::iterator pos_;
+  };
+  size_t k_;
+  std::list<frame_id_t> history_list_;
+  std::list<frame_id_t> cache_list_;
+  std::unordered_map<frame_id_t, MapFrame> data_;
+  std::mutex latch_;
+};
+
+// Simulates a buffer pool in which `num_pinned` frames stay pinned while the others are fetched and evicted.
+// Returns the average time of one access + evict round in nanoseconds.
+template <typename ReplacerType>
+auto ReplacerBenchmarkCall(size_t num_frames, size_t num_pinned, size_t k, size_t num_rounds) -> double {
+  ReplacerType replacer(num_frames, k);
+  std::default_random_engine rng(15445);
+  std::uniform_int_distribution<size_t> pinned_dist(0, num_pinned - 1);
+
+  // pinned frames are hot: they are accessed all the time and never become evictable
+  for (size_t i = 0; i < num_frames; i++) {
+    replacer.RecordAccess(static_cast<frame_id_t>(i));
+    replacer.SetEvictable(static_cast<frame_id_t>(i), i >= num_pinned);
+  }
+
+  auto clock_start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_rounds; i++) {
+    replacer.RecordAccess(static_cast<frame_id_t>(pinned_dist(rng)));
+    frame_id_t victim;
+    EXPECT_TRUE(replacer.Evict(&victim));
+    replacer.RecordAccess(victim);
+    replacer.SetEvictable(victim, true);
+  }
+  auto clock_end = std::chrono::steady_clock::now();
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_end - clock_start).count()) /
+         num_rounds;
+}
+
+TEST(LRUKReplacerBenchmarkTest, PinnedFramesBenchmark) {  // NOLINT
+  const size_t k = 2;
+  const size_t num_rounds = 20000;
+  std::cout << "This test compares the list-based and the ordered-index LRU-K replacer when most frames are pinned."
+            << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t num_frames : {1 << 8, 1 << 10, 1 << 12}) {
+    size_t num_pinned = num_frames - 16;
+    auto list_ns = ReplacerBenchmarkCall<ListLRUKReplacer>(num_frames, num_pinned, k, num_rounds);
+    auto index_ns = ReplacerBenchmarkCall<LRUKReplacer>(num_frames, num_pinned, k, num_rounds);
+    std::cout << "Frames: " << num_frames << " List Latency: " << list_ns << " ns"
+              << " Index Latency: " << index_ns << " ns"
+              << " Ratio: " << list_ns / index_ns << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
@@ -97,4 +97,46 @@ TEST(LRUKReplacerTest, SampleTest) {
   lru_replacer.Remove(1);
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, KDistanceTest) {
+  LRUKReplacer lru_replacer(7, 2);
+
+  // Scenario: access pattern 1, 2, 2, 1. Frame 1 was accessed last, but its second most recent access (t=0) is
+  // older than frame 2's (t=1), so frame 1 has the larger backward 2-distance.
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.SetEvictable(1, true);
+  lru_replacer.SetEvictable(2, true);
+
+  // Scenario: frame 3 has a single access and therefore +inf backward k-distance, even though it is the newest.
+  lru_replacer.RecordAccess(3);
+  lru_replacer.SetEvictable(3, true);
+  ASSERT_EQ(3, lru_replacer.Size());
+
+  // Scenario: the eviction candidates come in eviction order and are not evicted.
+  ASSERT_EQ((std::vector<frame_id_t>{3, 1}), lru_replacer.EvictionCandidates(2));
+  ASSERT_EQ(3, lru_replacer.Size());
+
+  int value;
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+
+  // Scenario: only the last k accesses count. Frame 4 was first seen before frame 2's last two accesses, but that
+  // access falls out of its window once it is accessed twice more.
+  lru_replacer.RecordAccess(4);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(4);
+  lru_replacer.RecordAccess(4);
+  lru_replacer.SetEvictable(4, true);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(4, value);
+  ASSERT_EQ(false, lru_replacer.Evict(&value));
+}
 }  // namespace bustub
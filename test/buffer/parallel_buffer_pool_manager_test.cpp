@@ -0,0 +1,252 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 5;
+  const size_t k = 2;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager, k);
+  EXPECT_EQ(buffer_pool_size * num_instances, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up the buffer pool.
+  for (size_t i = 1; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: Once the buffer pool is full, we should not be able to create any new pages.
+  for (size_t i = buffer_pool_size * num_instances; i < buffer_pool_size * num_instances * 2; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: After unpinning pages {0, 1, 2, 3, 4}, which were allocated from five different instances,
+  // we should still be able to fetch the data we wrote a while ago.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(i, true));
+  }
+  page0 = bpm->FetchPage(0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: every instance now has exactly one evictable frame, so five new pages can be created no matter
+  // which instance the round robin starts from. Afterwards all the buffer pages are pinned again.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, PageRoutingTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_instances = 3;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  // Scenario: every page id is owned by the instance it was allocated from.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_id, page->GetPageId());
+    EXPECT_EQ(page, bpm->GetBufferPoolManager(page_id)->FetchPage(page_id));
+    bpm->GetBufferPoolManager(page_id)->UnpinPage(page_id, false);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id);
+    page_ids.push_back(page_id);
+  }
+  for (auto page_id : page_ids) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: concurrent fetches of pages spread over all shards see the data written above.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_instances; t++) {
+    threads.emplace_back([&bpm, &page_ids]() {
+      for (int iter = 0; iter < 100; iter++) {
+        for (auto page_id : page_ids) {
+          auto *page = bpm->FetchPage(page_id);
+          if (page == nullptr) {
+            continue;
+          }
+          EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+          bpm->UnpinPage(page_id, false);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Scenario: an invalid page id is not routed to any shard.
+  EXPECT_EQ(nullptr, bpm->GetBufferPoolManager(INVALID_PAGE_ID));
+  EXPECT_EQ(nullptr, bpm->FetchPage(INVALID_PAGE_ID));
+  EXPECT_EQ(false, bpm->UnpinPage(INVALID_PAGE_ID, false));
+  EXPECT_EQ(false, bpm->FlushPage(INVALID_PAGE_ID));
+  EXPECT_EQ(true, bpm->DeletePage(INVALID_PAGE_ID));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ExtentTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_instances = 3;
+  const size_t k = 2;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager, k);
+
+  // Scenario: two tables grow at the same time, yet each one's pages are contiguous across all shards.
+  ExtentAllocator table_a;
+  ExtentAllocator table_b;
+  page_id_t page_id;
+  for (page_id_t i = 0; i < 2 * BUSTUB_EXTENT_SIZE; i++) {
+    ASSERT_NE(nullptr, bpm->NewPageInExtent(&page_id, &table_a));
+    EXPECT_EQ(i < BUSTUB_EXTENT_SIZE ? i : BUSTUB_EXTENT_SIZE + i, page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    ASSERT_NE(nullptr, bpm->NewPageInExtent(&page_id, &table_b));
+    EXPECT_EQ(i < BUSTUB_EXTENT_SIZE ? BUSTUB_EXTENT_SIZE + i : 2 * BUSTUB_EXTENT_SIZE + i, page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: pages outside of extents keep their stride per shard, behind the extents.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_LE(4 * BUSTUB_EXTENT_SIZE, page_id);
+  EXPECT_GT(4 * BUSTUB_EXTENT_SIZE + static_cast<page_id_t>(num_instances), page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, FlushAllTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_instances = 3;
+  const size_t k = 2;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager, k);
+
+  // Scenario: one batch writes the dirty pages of all shards, pinned or not, and leaves them clean.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size * num_instances; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id);
+    if (i % 2 == 1) {
+      ASSERT_EQ(page, bpm->FetchPage(page_id));
+    }
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  bpm->FlushAllPages();
+
+  char buf[BUSTUB_PAGE_SIZE];
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    disk_manager->ReadPage(page_ids[i], buf);
+    EXPECT_EQ(std::to_string(page_ids[i]), std::string(buf));
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_FALSE(page->IsDirty());
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+    if (i % 2 == 1) {
+      EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+    }
+  }
+
+  // the flushed frames can be evicted again
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+/** Fails every batched write, like a full disk would. */
+class FailingBatchDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  auto WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) -> bool override {
+    return false;
+  }
+};
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, FlushAllFailureTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_instances = 3;
+
+  auto *disk_manager = new FailingBatchDiskManager();
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  // Scenario: the pages of a failed batch stay dirty, so they are written again later.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_instances; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  bpm->FlushAllPages();
+  for (auto page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_TRUE(page->IsDirty());
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
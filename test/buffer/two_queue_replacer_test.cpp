@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer_test.cpp
+//
+// Identification: test/buffer/two_queue_replacer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(TwoQueueReplacerTest, SampleTest) {
+  // Kin = 2, Kout = 4
+  TwoQueueReplacer two_queue_replacer(8);
+
+  // Scenario: load pages 10, 11, 12 into frames 0-2. All of them enter A1in.
+  for (frame_id_t i = 0; i < 3; i++) {
+    two_queue_replacer.RecordAccess(i, 10 + i);
+    two_queue_replacer.SetEvictable(i, true);
+  }
+  ASSERT_EQ(3, two_queue_replacer.Size());
+
+  // Scenario: re-references in A1in are ignored, A1in is evicted in FIFO order and its pages go to A1out.
+  two_queue_replacer.RecordAccess(0, 10);
+  int value;
+  ASSERT_EQ(true, two_queue_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+
+  // Scenario: page 10 is loaded again while it is in A1out, so it is hot and enters Am in frame 3.
+  two_queue_replacer.RecordAccess(3, 10);
+  two_queue_replacer.SetEvictable(3, true);
+  ASSERT_EQ(3, two_queue_replacer.Size());
+
+  // Scenario: A1in holds 2 frames, which is not more than Kin, so the LRU frame of Am is evicted.
+  ASSERT_EQ(true, two_queue_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+
+  // Scenario: pages evicted from Am are not remembered; loading page 10 again puts it back into A1in.
+  two_queue_replacer.RecordAccess(3, 10);
+  two_queue_replacer.SetEvictable(3, true);
+  ASSERT_EQ(true, two_queue_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+
+  // Scenario: pinned frames are skipped, and removed frames are forgotten.
+  two_queue_replacer.SetEvictable(2, false);
+  ASSERT_EQ(1, two_queue_replacer.Size());
+  ASSERT_EQ(true, two_queue_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+  ASSERT_EQ(false, two_queue_replacer.Evict(&value));
+  two_queue_replacer.SetEvictable(2, true);
+  two_queue_replacer.Remove(2);
+  ASSERT_EQ(0, two_queue_replacer.Size());
+}
+
+}  // namespace bustub
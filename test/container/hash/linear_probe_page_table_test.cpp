@@ -0,0 +1,146 @@
+/**
+ * linear_probe_page_table_test.cpp
+ */
+
+#include <memory>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "container/hash/linear_probe_page_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LinearProbePageTableTest, SampleTest) {
+  auto table = std::make_unique<LinearProbePageTable>(10);
+  EXPECT_EQ(32, table->GetCapacity());
+
+  for (page_id_t i = 0; i < 10; i++) {
+    table->Insert(i, i + 100);
+  }
+
+  frame_id_t result;
+  for (page_id_t i = 0; i < 10; i++) {
+    EXPECT_TRUE(table->Find(i, result));
+    EXPECT_EQ(i + 100, result);
+  }
+  EXPECT_FALSE(table->Find(10, result));
+
+  // Scenario: inserting an existing page overwrites its frame.
+  table->Insert(3, 7);
+  EXPECT_TRUE(table->Find(3, result));
+  EXPECT_EQ(7, result);
+
+  EXPECT_TRUE(table->Remove(8));
+  EXPECT_TRUE(table->Remove(4));
+  EXPECT_FALSE(table->Remove(4));
+  EXPECT_FALSE(table->Remove(20));
+  EXPECT_FALSE(table->Find(8, result));
+  EXPECT_FALSE(table->Find(4, result));
+  EXPECT_TRUE(table->Find(9, result));
+  EXPECT_EQ(109, result);
+}
+
+TEST(LinearProbePageTableTest, ChurnTest) {
+  // Scenario: a buffer pool keeps replacing the pages it holds. Removed entries must not clog the table.
+  const size_t max_size = 64;
+  auto table = std::make_unique<LinearProbePageTable>(max_size);
+  for (page_id_t i = 0; i < static_cast<page_id_t>(max_size); i++) {
+    table->Insert(i, i);
+  }
+  frame_id_t result;
+  for (page_id_t i = max_size; i < 100000; i++) {
+    auto evicted = static_cast<page_id_t>(i - max_size);
+    ASSERT_TRUE(table->Find(evicted, result));
+    ASSERT_TRUE(table->Remove(evicted));
+    table->Insert(i, result);
+    ASSERT_FALSE(table->Find(evicted, result));
+  }
+  for (page_id_t i = 100000 - max_size; i < 100000; i++) {
+    EXPECT_TRUE(table->Find(i, result));
+    EXPECT_EQ(i % max_size, result);
+  }
+}
+
+TEST(LinearProbePageTableTest, RandomChurnProbeLengthTest) {
+  // Scenario: a pool at half the table's capacity evicts random pages for many turnovers. Removals must not leave
+  // anything behind that makes later lookups probe further.
+  const size_t max_size = 2048;
+  const size_t turnovers = 25;
+  auto table = std::make_unique<LinearProbePageTable>(max_size);
+  std::vector<page_id_t> resident;
+  for (page_id_t i = 0; i < static_cast<page_id_t>(max_size); i++) {
+    table->Insert(i, i);
+    resident.push_back(i);
+  }
+
+  std::mt19937 rng(15445);
+  frame_id_t result;
+  auto next_page_id = static_cast<page_id_t>(max_size);
+  for (size_t i = 0; i < turnovers * max_size; i++) {
+    auto victim = rng() % max_size;
+    ASSERT_TRUE(table->Find(resident[victim], result));
+    ASSERT_EQ(static_cast<frame_id_t>(victim), result);
+    ASSERT_TRUE(table->Remove(resident[victim]));
+    ASSERT_FALSE(table->Find(resident[victim], result));
+    resident[victim] = next_page_id++;
+    table->Insert(resident[victim], static_cast<frame_id_t>(victim));
+  }
+
+  // at load factor 1/2 a miss probes 2.5 slots on average, a hit 1.5
+  size_t hit_probes = 0;
+  for (size_t frame = 0; frame < max_size; frame++) {
+    ASSERT_TRUE(table->Find(resident[frame], result));
+    EXPECT_EQ(static_cast<frame_id_t>(frame), result);
+    hit_probes += table->GetProbeLength(resident[frame]);
+  }
+  size_t miss_probes = 0;
+  for (page_id_t i = 0; i < static_cast<page_id_t>(max_size); i++) {
+    miss_probes += table->GetProbeLength(next_page_id + i);
+  }
+  EXPECT_LT(hit_probes, 4 * max_size);
+  EXPECT_LT(miss_probes, 8 * max_size);
+}
+
+TEST(LinearProbePageTableTest, ConcurrentFindTest) {
+  const size_t max_size = 128;
+  const int num_readers = 3;
+  auto table = std::make_unique<LinearProbePageTable>(max_size);
+
+  // the first half of the pages stays in the table, the second half is churned by a writer
+  for (page_id_t i = 0; i < static_cast<page_id_t>(max_size / 2); i++) {
+    table->Insert(i, i);
+  }
+
+  std::vector<std::thread> threads;
+  threads.emplace_back([&table]() {
+    for (int round = 0; round < 1000; round++) {
+      for (page_id_t i = max_size / 2; i < static_cast<page_id_t>(max_size); i++) {
+        table->Insert(i, i);
+      }
+      for (page_id_t i = max_size / 2; i < static_cast<page_id_t>(max_size); i++) {
+        table->Remove(i);
+      }
+    }
+  });
+  for (int tid = 0; tid < num_readers; tid++) {
+    threads.emplace_back([&table]() {
+      frame_id_t result;
+      for (int round = 0; round < 1000; round++) {
+        for (page_id_t i = 0; i < static_cast<page_id_t>(max_size); i++) {
+          if (table->Find(i, result)) {
+            EXPECT_EQ(i, result);
+          } else {
+            EXPECT_GE(i, static_cast<page_id_t>(max_size / 2));
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,61 @@
+/**
+ * page_table_benchmark_test.cpp
+ */
+
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "container/hash/extendible_hash_table.h"
+#include "container/hash/linear_probe_page_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// Runs the page table operations of a buffer pool that keeps replacing its pages: every step looks up a resident
+// page, then evicts the oldest page and loads a new one. Returns the number of operations per microsecond.
+auto PageTableThroughputCall(HashTable<page_id_t, frame_id_t> *table, size_t pool_size, size_t num_steps) -> double {
+  for (page_id_t i = 0; i < static_cast<page_id_t>(pool_size); i++) {
+    table->Insert(i, i);
+  }
+
+  frame_id_t frame_id;
+  size_t num_found = 0;
+  auto clock_start = std::chrono::steady_clock::now();
+  for (size_t step = 0; step < num_steps; step++) {
+    auto newest = static_cast<page_id_t>(pool_size + step);
+    auto oldest = static_cast<page_id_t>(step);
+    // a few hits on resident pages for every miss
+    for (page_id_t i = 1; i <= 4; i++) {
+      num_found += static_cast<size_t>(table->Find(newest - i * 7, frame_id));
+    }
+    table->Find(oldest, frame_id);
+    table->Remove(oldest);
+    table->Insert(newest, frame_id);
+  }
+  auto clock_end = std::chrono::steady_clock::now();
+  EXPECT_EQ(4 * num_steps, num_found);
+
+  auto elapsed_us =
+      static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(clock_end - clock_start).count());
+  return static_cast<double>(7 * num_steps) / elapsed_us;
+}
+
+TEST(PageTableBenchmarkTest, ThroughputTest) {  // NOLINT
+  const size_t num_steps = 200000;
+  std::cout << "This test will compare the page table throughput of ExtendibleHashTable and LinearProbePageTable."
+            << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t pool_size : {128, 4096, 65536}) {
+    auto extendible = std::make_unique<ExtendibleHashTable<page_id_t, frame_id_t>>(4);
+    auto linear_probe = std::make_unique<LinearProbePageTable>(pool_size);
+    auto extendible_ops = PageTableThroughputCall(extendible.get(), pool_size, num_steps);
+    auto linear_probe_ops = PageTableThroughputCall(linear_probe.get(), pool_size, num_steps);
+    std::cout << "Pool Size: " << pool_size << " ExtendibleHashTable: " << extendible_ops
+              << " ops/us LinearProbePageTable: " << linear_probe_ops << " ops/us" << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
@@ -17,6 +18,7 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/index/b_plus_tree.h"
 #include "test_util.h"  // NOLINT
 
@@ -333,4 +335,116 @@ TEST(BPlusTreeConcurrentTest, MixTest) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, ReadDuringRootChangeTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  // tiny nodes, so that the writer splits and collapses the root all the time
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  InsertHelper(&tree, {0});
+
+  // readers never take a tree-wide latch, they must still always find the root
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; i++) {
+    readers.emplace_back([&tree, &done] {
+      GenericKey<8> index_key;
+      std::vector<RID> rids;
+      while (!done) {
+        index_key.SetFromInteger(0);
+        EXPECT_TRUE(tree.GetValue(index_key, &rids));
+        index_key.SetFromInteger(-1);
+        EXPECT_FALSE(tree.GetValue(index_key, &rids));
+      }
+    });
+  }
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 50; key++) {
+    keys.push_back(key);
+  }
+  for (int round = 0; round < 20; round++) {
+    InsertHelper(&tree, keys);
+    DeleteHelper(&tree, keys);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  int64_t size = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    size = size + 1;
+  }
+  EXPECT_EQ(size, 1);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BPlusTreeConcurrentTest, ReadDuringSplitAndMergeTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(256, disk_manager);
+  // small nodes, so that the writers split and merge internal pages all the time
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  std::vector<int64_t> even_keys;
+  for (int64_t key = 0; key < 200; key += 2) {
+    even_keys.push_back(key);
+  }
+  InsertHelper(&tree, even_keys);
+
+  // readers do not latch the internal pages, a page that changed under them must never send them the wrong way
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; i++) {
+    readers.emplace_back([&tree, &done, &even_keys] {
+      GenericKey<8> index_key;
+      std::vector<RID> rids;
+      while (!done) {
+        for (auto key : even_keys) {
+          rids.clear();
+          index_key.SetFromInteger(key);
+          EXPECT_TRUE(tree.GetValue(index_key, &rids));
+          EXPECT_EQ(rids.size(), 1);
+          EXPECT_EQ(rids[0].GetSlotNum(), key);
+        }
+      }
+    });
+  }
+  std::vector<int64_t> odd_keys;
+  for (int64_t key = 1; key < 200; key += 2) {
+    odd_keys.push_back(key);
+  }
+  for (int round = 0; round < 10; round++) {
+    InsertHelper(&tree, odd_keys);
+    DeleteHelper(&tree, odd_keys);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  int64_t current_key = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 2;
+  }
+  EXPECT_EQ(current_key, 200);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -2,18 +2,26 @@
  * b_plus_tree_contention_test.cpp
  */
 
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
 #include <future>  // NOLINT
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_instance.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager_memory.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -154,4 +162,293 @@ TEST(BPlusTreeTest, BPlusTreeContentionBenchmark2) {  // NOLINT
             << std::endl;
 }
 
+// Throughput in operations per millisecond of `num_threads` writers that each insert and then remove their own keys
+// in a tree that already holds `num_keys` keys, so that most writes leave their leaf safe.
+auto BPlusTreeWriterThroughputCall(size_t num_threads, bool optimistic_latching) -> double {
+  const int64_t num_keys = 5000;
+  const int64_t keys_per_round = 32;
+  const int64_t num_rounds = 50;
+
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 64, 64, optimistic_latching);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  GenericKey<8> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+  for (int64_t key = 0; key < num_keys; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key * 2);
+    tree.Insert(index_key, rid, transaction);
+  }
+  delete transaction;
+
+  std::vector<std::thread> threads;
+  auto clock_start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&tree, i, num_threads, num_keys, keys_per_round, num_rounds] {
+      GenericKey<8> index_key;
+      RID rid;
+      auto *transaction = new Transaction(static_cast<txn_id_t>(i + 1));
+      // odd keys spread over the whole tree, different for every thread
+      for (int64_t round = 0; round < num_rounds; round++) {
+        for (int64_t j = 0; j < keys_per_round; j++) {
+          auto key = ((round * keys_per_round + j) * static_cast<int64_t>(num_threads) + i) % num_keys * 2 + 1;
+          rid.Set(0, key);
+          index_key.SetFromInteger(key);
+          tree.Insert(index_key, rid, transaction);
+        }
+        for (int64_t j = 0; j < keys_per_round; j++) {
+          auto key = ((round * keys_per_round + j) * static_cast<int64_t>(num_threads) + i) % num_keys * 2 + 1;
+          index_key.SetFromInteger(key);
+          tree.Remove(index_key, transaction);
+        }
+      }
+      delete transaction;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto clock_end = std::chrono::steady_clock::now();
+
+  // the writers left the keys of the tree alone
+  std::vector<RID> result;
+  for (int64_t key = 0; key < num_keys * 2; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(key % 2 == 0, tree.GetValue(index_key, &result));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  auto num_ops = static_cast<double>(num_threads * num_rounds * keys_per_round * 2);
+  return num_ops / static_cast<double>(
+                       std::chrono::duration_cast<std::chrono::microseconds>(clock_end - clock_start).count() + 1) *
+         1000;
+}
+
+TEST(BPlusTreeTest, BPlusTreeWriterScalingBenchmark) {  // NOLINT
+  std::cout << "This test will see how writers scale with optimistic and with pessimistic latch crabbing." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t num_threads : {1, 2, 4, 8}) {
+    auto pessimistic = BPlusTreeWriterThroughputCall(num_threads, false);
+    auto optimistic = BPlusTreeWriterThroughputCall(num_threads, true);
+    std::cout << "Threads: " << num_threads << " Pessimistic: " << pessimistic << " ops/ms Optimistic: " << optimistic
+              << " ops/ms" << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+// Throughput in lookups per millisecond of `num_threads` readers that look up keys spread over a tree of `num_keys`
+// keys, while one writer keeps inserting and removing other keys.
+auto BPlusTreeReaderThroughputCall(size_t num_threads, bool optimistic_latching) -> double {
+  const int64_t num_keys = 5000;
+  const int64_t num_lookups = 5000;
+
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 64, 64, optimistic_latching);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  GenericKey<8> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+  for (int64_t key = 0; key < num_keys; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key * 2);
+    tree.Insert(index_key, rid, transaction);
+  }
+  delete transaction;
+
+  std::atomic<bool> done{false};
+  std::thread writer([&tree, &done, num_keys] {
+    GenericKey<8> index_key;
+    RID rid;
+    auto *transaction = new Transaction(1);
+    for (int64_t key = 1; !done; key = (key + 2) % (num_keys * 2)) {
+      rid.Set(0, key);
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, rid, transaction);
+      tree.Remove(index_key, transaction);
+    }
+    delete transaction;
+  });
+
+  std::vector<std::thread> readers;
+  auto clock_start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_threads; i++) {
+    readers.emplace_back([&tree, i, num_keys, num_lookups] {
+      GenericKey<8> index_key;
+      std::vector<RID> result;
+      for (int64_t j = 0; j < num_lookups; j++) {
+        result.clear();
+        auto key = (j * 7919 + static_cast<int64_t>(i) * 104729) % num_keys * 2;
+        index_key.SetFromInteger(key);
+        EXPECT_TRUE(tree.GetValue(index_key, &result));
+      }
+    });
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  auto clock_end = std::chrono::steady_clock::now();
+  done = true;
+  writer.join();
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  auto num_ops = static_cast<double>(num_threads * num_lookups);
+  return num_ops / static_cast<double>(
+                       std::chrono::duration_cast<std::chrono::microseconds>(clock_end - clock_start).count() + 1) *
+         1000;
+}
+
+TEST(BPlusTreeTest, BPlusTreeReaderScalingBenchmark) {  // NOLINT
+  std::cout << "This test will see how readers scale with version-validated and with latched descents." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t num_threads : {1, 2, 4, 8}) {
+    auto latched = BPlusTreeReaderThroughputCall(num_threads, false);
+    auto validated = BPlusTreeReaderThroughputCall(num_threads, true);
+    std::cout << "Threads: " << num_threads << " Latched: " << latched << " ops/ms Validated: " << validated
+              << " ops/ms" << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+// inserting 1M keys one by one takes half a minute in a debug build, run it with --gtest_also_run_disabled_tests
+TEST(BPlusTreeTest, DISABLED_BPlusTreeBulkLoadBenchmark) {  // NOLINT
+  std::cout << "This test will see how long building an index takes key by key and bulk loaded." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+
+  // the keys of __mock_t7.v1, 1M rows in key order; filling a table heap that large through SQL takes too long
+  {
+    const int64_t num_keys = 1000000;
+    auto key_schema = ParseCreateStatement("a bigint");
+    GenericComparator<8> comparator(key_schema.get());
+    auto *disk_manager = new DiskManagerUnlimitedMemory();
+    auto *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> by_key_tree("by_key", bpm, comparator);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> bulk_load_tree("bulk_load", bpm, comparator);
+    GenericKey<8> index_key;
+
+    auto clock_start = std::chrono::steady_clock::now();
+    Transaction transaction(0);
+    for (int64_t key = 0; key < num_keys; key++) {
+      index_key.SetFromInteger(key);
+      by_key_tree.Insert(index_key, RID(0, key), &transaction);
+    }
+    auto by_key_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - clock_start).count();
+
+    clock_start = std::chrono::steady_clock::now();
+    std::vector<std::pair<GenericKey<8>, RID>> entries;
+    entries.reserve(num_keys);
+    for (int64_t key = 0; key < num_keys; key++) {
+      index_key.SetFromInteger(key);
+      entries.emplace_back(index_key, RID(0, key));
+    }
+    bulk_load_tree.BulkLoad(&entries);
+    auto bulk_load_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - clock_start).count();
+
+    std::vector<RID> rids;
+    for (int64_t key = 0; key < num_keys; key += 9973) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(by_key_tree.GetValue(index_key, &rids));
+      EXPECT_TRUE(bulk_load_tree.GetValue(index_key, &rids));
+    }
+    std::cout << "1M keys: Key by key: " << by_key_ms << " ms Bulk load: " << bulk_load_ms << " ms" << std::endl;
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+  }
+
+  // CREATE INDEX on a table with the first rows of __mock_t7
+  {
+    BustubInstance bustub;
+    bustub.GenerateMockTable();
+    // the indexes keep their roots in the header page, which must not be a page of the table
+    page_id_t page_id;
+    bustub.buffer_pool_manager_->NewPage(&page_id);
+    bustub.buffer_pool_manager_->UnpinPage(page_id, true);
+    std::stringstream ss;
+    auto writer = SimpleStreamWriter(ss, true);
+    bustub.ExecuteSql("CREATE TABLE t7(v INT, v1 INT, v2 INT);", writer);
+    bustub.ExecuteSql("INSERT INTO t7 SELECT * FROM __mock_t7 LIMIT 10000;", writer);
+    auto *table_info = bustub.catalog_->GetTable("t7");
+
+    // key by key, the way CREATE INDEX built indexes before bulk loading
+    auto clock_start = std::chrono::steady_clock::now();
+    BPlusTreeIndexForOneIntegerColumn index(
+        std::make_unique<IndexMetadata>("t7v1_by_key", "t7", &table_info->schema_, std::vector<uint32_t>{1}),
+        bustub.buffer_pool_manager_);
+    Transaction transaction(0);
+    for (auto tuple = table_info->table_->Begin(&transaction); tuple != table_info->table_->End(); ++tuple) {
+      index.InsertEntry(tuple->KeyFromTuple(table_info->schema_, *index.GetKeySchema(), index.GetKeyAttrs()),
+                        tuple->GetRid(), &transaction);
+    }
+    auto by_key_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - clock_start).count();
+
+    // scanned and sorted by one and by several threads
+    std::vector<std::unique_ptr<BPlusTreeIndexForOneIntegerColumn>> parallel_indexes;
+    std::vector<int64_t> parallel_ms;
+    for (size_t num_threads : {1, 4}) {
+      clock_start = std::chrono::steady_clock::now();
+      parallel_indexes.push_back(std::make_unique<BPlusTreeIndexForOneIntegerColumn>(
+          std::make_unique<IndexMetadata>("t7v1_" + std::to_string(num_threads), "t7", &table_info->schema_,
+                                          std::vector<uint32_t>{1}),
+          bustub.buffer_pool_manager_));
+      parallel_indexes.back()->BuildFromTable(table_info->table_.get(), table_info->schema_, num_threads,
+                                              &transaction);
+      parallel_ms.push_back(
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - clock_start)
+              .count());
+    }
+
+    // with all cores
+    clock_start = std::chrono::steady_clock::now();
+    bustub.ExecuteSql("CREATE INDEX t7v1 ON t7(v1);", writer);
+    auto create_index_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - clock_start).count();
+
+    // all indexes find every row
+    auto *index_info = bustub.catalog_->GetIndex("t7v1", "t7");
+    ASSERT_NE(index_info, nullptr);
+    std::vector<RID> by_key_rids;
+    for (int32_t key = 0; key < 10000; key += 997) {
+      Tuple index_key{std::vector<Value>{ValueFactory::GetIntegerValue(key)}, index.GetKeySchema()};
+      index.ScanKey(index_key, &by_key_rids, &transaction);
+    }
+    EXPECT_EQ(by_key_rids.size(), 11);
+    std::vector<Index *> bulk_loaded_indexes{parallel_indexes[0].get(), parallel_indexes[1].get(),
+                                             index_info->index_.get()};
+    for (auto *bulk_loaded_index : bulk_loaded_indexes) {
+      std::vector<RID> rids;
+      for (int32_t key = 0; key < 10000; key += 997) {
+        Tuple index_key{std::vector<Value>{ValueFactory::GetIntegerValue(key)}, index.GetKeySchema()};
+        bulk_loaded_index->ScanKey(index_key, &rids, &transaction);
+      }
+      EXPECT_EQ(by_key_rids, rids);
+    }
+    std::cout << "CREATE INDEX on 10k rows: Key by key: " << by_key_ms << " ms Bulk load, 1 thread: " << parallel_ms[0]
+              << " ms 4 threads: " << parallel_ms[1] << " ms " << std::thread::hardware_concurrency()
+              << " threads: " << create_index_ms << " ms"
+              << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
 }  // namespace bustub
@@ -12,9 +12,13 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
+#include <tuple>
+#include <utility>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/index/b_plus_tree.h"
 #include "test_util.h"  // NOLINT
 
@@ -195,4 +199,69 @@ TEST(BPlusTreeTests, InsertTest3) {
   remove("test.db");
   remove("test.log");
 }
+TEST(BPlusTreeTests, BulkLoadTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  // leaf max size, internal max size, fill factor
+  std::vector<std::tuple<int, int, double>> configs = {
+      {3, 3, 1.0}, {4, 4, 0.5}, {5, 5, 0.9}, {128, 128, BULK_LOAD_FILL_FACTOR}};
+  for (const auto &[leaf_max_size, internal_max_size, fill_factor] : configs) {
+    for (int64_t num_keys : {1, 2, 7, 100, 1000}) {
+      auto *disk_manager = new DiskManagerUnlimitedMemory();
+      BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+      BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, leaf_max_size,
+                                                               internal_max_size);
+      page_id_t page_id;
+      bpm->NewPage(&page_id);
+
+      std::vector<std::pair<GenericKey<8>, RID>> entries;
+      GenericKey<8> index_key;
+      for (int64_t key = 0; key < num_keys; key++) {
+        index_key.SetFromInteger(key);
+        entries.emplace_back(index_key, RID(0, key));
+      }
+      std::shuffle(entries.begin(), entries.end(), std::mt19937(15445));
+      // only the first entry of a duplicate key is loaded
+      index_key.SetFromInteger(0);
+      entries.emplace_back(index_key, RID(1, 0));
+      ASSERT_TRUE(tree.BulkLoad(&entries, fill_factor));
+
+      std::vector<RID> rids;
+      for (int64_t key = 0; key < num_keys; key++) {
+        rids.clear();
+        index_key.SetFromInteger(key);
+        ASSERT_TRUE(tree.GetValue(index_key, &rids));
+        EXPECT_EQ(rids[0], RID(0, key));
+      }
+      int64_t current_key = 0;
+      for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+        EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+        current_key = current_key + 1;
+      }
+      EXPECT_EQ(current_key, num_keys);
+
+      // only an empty tree can be loaded
+      EXPECT_FALSE(tree.BulkLoad(&entries, fill_factor));
+
+      // the loaded tree splits and merges like any other
+      auto *transaction = new Transaction(0);
+      for (int64_t key = num_keys; key < num_keys + 50; key++) {
+        index_key.SetFromInteger(key);
+        EXPECT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+      }
+      for (int64_t key = 0; key < num_keys + 50; key++) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, transaction);
+      }
+      EXPECT_TRUE(tree.IsEmpty());
+      delete transaction;
+
+      bpm->UnpinPage(HEADER_PAGE_ID, true);
+      delete bpm;
+      delete disk_manager;
+    }
+  }
+}
 }  // namespace bustub
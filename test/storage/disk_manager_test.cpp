@@ -10,11 +10,30 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>  // NOLINT
+#include <cstdint>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_compressed.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/disk/disk_manager_simulated.h"
+#include "storage/disk/disk_manager_uring.h"
+#include "storage/disk/extent_allocator.h"
+#include "storage/disk/lz_codec.h"
 
 namespace bustub {
 
@@ -24,12 +43,18 @@ class DiskManagerTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    remove("test.fsm");
+    remove("test.ext");
+    remove("test.map");
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
     remove("test.log");
+    remove("test.fsm");
+    remove("test.ext");
+    remove("test.map");
   };
 };
 
@@ -73,6 +98,732 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
 }
 
 // NOLINTNEXTLINE
-TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
+TEST_F(DiskManagerTest, PosixReadWritePageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  char zeros[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  {
+    PosixDiskManager dm(db_file);
+    std::memset(buf, 1, sizeof(buf));
+    dm.ReadPage(0, buf);  // tolerate empty read
+    EXPECT_EQ(std::memcmp(buf, zeros, sizeof(buf)), 0);
+    EXPECT_EQ(0, dm.GetDbFileSize());
+
+    dm.WritePage(0, data);
+    dm.ReadPage(0, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+    std::memset(buf, 0, sizeof(buf));
+    dm.WritePage(5, data);
+    dm.ReadPage(5, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    EXPECT_EQ(6 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+    EXPECT_EQ(2, dm.GetNumWrites());
+
+    dm.SyncPages();
+    dm.ShutDown();
+  }
+
+  // Scenario: the pages and the file size survive reopening the file.
+  PosixDiskManager dm(db_file);
+  EXPECT_EQ(6 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+  dm.ReadPage(5, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(std::memcmp(buf, zeros, sizeof(buf)), 0);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FailedWritePageTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  // Scenario: the fstream backend reports writes to a closed database file.
+  {
+    DiskManager dm(db_file);
+    EXPECT_TRUE(dm.WritePage(0, data));
+    EXPECT_TRUE(dm.WritePageAsync(1, data).Wait());
+    dm.ShutDown();
+    EXPECT_FALSE(dm.WritePage(0, data));
+    EXPECT_FALSE(dm.WritePageAsync(1, data).Wait());
+  }
+
+  // Scenario: the pwrite() backend reports them as well, synchronous and asynchronous.
+  PosixDiskManager dm(db_file);
+  EXPECT_TRUE(dm.WritePage(0, data));
+  EXPECT_TRUE(dm.WritePageAsync(1, data).Wait());
+  const char *pages[] = {data, data};
+  EXPECT_TRUE(dm.WritePages(2, pages, 2));
+  dm.ShutDown();
+  EXPECT_FALSE(dm.WritePage(0, data));
+  EXPECT_FALSE(dm.WritePageAsync(1, data).Wait());
+  EXPECT_FALSE(dm.WritePages(2, pages, 2));
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixConcurrentReadWriteTest) {
+  const int num_threads = 4;
+  const int num_pages = 64;
+  std::string db_file("test.db");
+  PosixDiskManager dm(db_file);
+
+  // every thread writes and reads back its own pages, interleaved with the other threads' pages
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&dm, tid]() {
+      char data[BUSTUB_PAGE_SIZE];
+      char buf[BUSTUB_PAGE_SIZE];
+      for (page_id_t page_id = tid; page_id < num_pages; page_id += num_threads) {
+        std::memset(data, page_id, sizeof(data));
+        dm.WritePage(page_id, data);
+        dm.ReadPage(page_id, buf);
+        EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_pages * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+  EXPECT_EQ(num_pages, dm.GetNumWrites());
+  char buf[BUSTUB_PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ(static_cast<char>(page_id), buf[BUSTUB_PAGE_SIZE - 1]);
+  }
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncReadWritePageTest) {
+  const int num_pages = 200;
+  std::string db_file("test.db");
+  UringDiskManager dm(db_file, 32, 8);
+
+  // more requests than the queue holds, all buffers stay alive until their request completed
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<DiskRequest> requests;
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    std::memset(pages[page_id].data(), page_id, BUSTUB_PAGE_SIZE);
+    requests.push_back(dm.WritePageAsync(page_id, pages[page_id].data()));
+  }
+  for (auto &request : requests) {
+    EXPECT_TRUE(request.Wait());
+    EXPECT_TRUE(request.IsDone());
+  }
+  EXPECT_EQ(num_pages * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+  EXPECT_EQ(num_pages, dm.GetNumWrites());
+
+  std::vector<std::vector<char>> bufs(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  requests.clear();
+  for (page_id_t page_id = num_pages - 1; page_id >= 0; page_id--) {
+    requests.push_back(dm.ReadPageAsync(page_id, bufs[page_id].data()));
+  }
+  // tolerate read past the end of the file
+  char buf[BUSTUB_PAGE_SIZE];
+  std::memset(buf, 1, sizeof(buf));
+  EXPECT_TRUE(dm.ReadPageAsync(num_pages, buf).Wait());
+  EXPECT_EQ(0, buf[0]);
+  for (auto &request : requests) {
+    EXPECT_TRUE(request.Wait());
+  }
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    EXPECT_EQ(pages[page_id], bufs[page_id]);
+  }
+
+  // the synchronous interface sees the asynchronous writes
+  dm.ReadPage(num_pages / 2, buf);
+  EXPECT_EQ(0, std::memcmp(buf, pages[num_pages / 2].data(), sizeof(buf)));
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncBatchedSubmissionTest) {
+  const int num_threads = 4;
+  const int num_pages = 64;
+  std::string db_file("test.db");
+  UringDiskManager dm(db_file, 16, 8);
+  if (!dm.IsAsync()) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+
+  // a batch is only handed to the kernel once it is full
+  char data[BUSTUB_PAGE_SIZE];
+  std::memset(data, 'x', sizeof(data));
+  std::vector<DiskRequest> requests;
+  for (page_id_t page_id = 0; page_id < 8; page_id++) {
+    requests.push_back(dm.WritePageAsync(page_id, data));
+  }
+  for (auto &request : requests) {
+    EXPECT_TRUE(request.Wait());
+  }
+  EXPECT_EQ(1, dm.GetNumSubmits());
+
+  // an incomplete batch goes out when it is submitted explicitly, or when it is waited for
+  auto request = dm.WritePageAsync(8, data);
+  dm.SubmitAsyncIo();
+  EXPECT_EQ(2, dm.GetNumSubmits());
+  EXPECT_TRUE(request.Wait());
+  EXPECT_TRUE(dm.WritePageAsync(9, data).Wait());
+  EXPECT_EQ(3, dm.GetNumSubmits());
+
+  // several threads share the ring
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&dm, tid]() {
+      std::vector<std::vector<char>> pages;
+      std::vector<DiskRequest> thread_requests;
+      for (page_id_t page_id = tid; page_id < num_pages; page_id += num_threads) {
+        pages.emplace_back(BUSTUB_PAGE_SIZE, static_cast<char>(page_id));
+        thread_requests.push_back(dm.WritePageAsync(page_id, pages.back().data()));
+      }
+      for (auto &thread_request : thread_requests) {
+        EXPECT_TRUE(thread_request.Wait());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  char buf[BUSTUB_PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ(static_cast<char>(page_id), buf[BUSTUB_PAGE_SIZE - 1]);
+  }
+  dm.ShutDown();
+}
+
+/** @return the file descriptor of the io_uring instance of this process, -1 if there is none */
+auto FindRingFd() -> int {
+  for (const auto &entry : std::filesystem::directory_iterator("/proc/self/fd")) {
+    std::error_code error;
+    if (std::filesystem::read_symlink(entry.path(), error).string() == "anon_inode:[io_uring]") {
+      return std::stoi(entry.path().filename().string());
+    }
+  }
+  return -1;
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncSubmissionFailureTest) {
+  std::string db_file("test.db");
+  UringDiskManager dm(db_file, 16, 8);
+  if (!dm.IsAsync()) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  char data[BUSTUB_PAGE_SIZE];
+  char buf[BUSTUB_PAGE_SIZE];
+  std::memset(data, 'x', sizeof(data));
+  EXPECT_TRUE(dm.WritePageAsync(0, data).Wait());
+
+  // Scenario: io_uring_enter() fails for good while a request is queued. The request fails instead of waiting forever,
+  // and later requests take the synchronous path.
+  auto request = dm.WritePageAsync(1, data);
+  int ring_fd = FindRingFd();
+  ASSERT_GE(ring_fd, 0);
+  int null_fd = open("/dev/null", O_RDONLY);
+  ASSERT_EQ(ring_fd, dup2(null_fd, ring_fd));
+  close(null_fd);
+  EXPECT_FALSE(request.Wait());
+  EXPECT_FALSE(dm.IsAsync());
+
+  EXPECT_TRUE(dm.WritePageAsync(1, data).Wait());
+  EXPECT_TRUE(dm.ReadPageAsync(1, buf).Wait());
+  EXPECT_EQ(0, std::memcmp(data, buf, sizeof(buf)));
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIoReadWritePageTest) {
+  std::string db_file("test.db");
+  PosixDiskManager dm(db_file, true);
+  if (!dm.IsDirectIo()) {
+    GTEST_SKIP() << "the file system does not support O_DIRECT";
+  }
+
+  // an aligned buffer goes to the device as it is, an unaligned one through the bounce buffer
+  alignas(BUSTUB_PAGE_SIZE) char aligned[BUSTUB_PAGE_SIZE];
+  char unaligned_storage[BUSTUB_PAGE_SIZE + 1];
+  char *unaligned = unaligned_storage + 1;
+  std::memset(aligned, 'a', sizeof(aligned));
+  std::memset(unaligned, 'u', BUSTUB_PAGE_SIZE);
+  dm.WritePage(0, aligned);
+  dm.WritePage(1, unaligned);
+  EXPECT_EQ(2 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+
+  dm.ReadPage(1, aligned);
+  EXPECT_EQ('u', aligned[0]);
+  EXPECT_EQ('u', aligned[BUSTUB_PAGE_SIZE - 1]);
+  dm.ReadPage(0, unaligned);
+  EXPECT_EQ('a', unaligned[0]);
+  EXPECT_EQ('a', unaligned[BUSTUB_PAGE_SIZE - 1]);
+  dm.ShutDown();
+
+  // the asynchronous interface accepts both kinds of buffers as well
+  UringDiskManager uring_dm(db_file, 8, 1, true);
+  std::memset(aligned, 0, sizeof(aligned));
+  std::memset(unaligned, 0, BUSTUB_PAGE_SIZE);
+  auto aligned_read = uring_dm.ReadPageAsync(0, aligned);
+  auto unaligned_read = uring_dm.ReadPageAsync(1, unaligned);
+  EXPECT_TRUE(aligned_read.Wait());
+  EXPECT_TRUE(unaligned_read.Wait());
+  EXPECT_EQ('a', aligned[BUSTUB_PAGE_SIZE - 1]);
+  EXPECT_EQ('u', unaligned[BUSTUB_PAGE_SIZE - 1]);
+  uring_dm.ShutDown();
+}
+
+/** @return the VmFlags of the memory mapping that holds the address, e.g. "sr" for MADV_SEQUENTIAL */
+auto GetMappingFlags(const char *address) -> std::string {
+  std::ifstream smaps("/proc/self/smaps");
+  std::string line;
+  bool found = false;
+  while (std::getline(smaps, line)) {
+    uintptr_t start;
+    uintptr_t end;
+    char dash;
+    std::istringstream range(line);
+    if (range >> std::hex >> start >> dash >> end && dash == '-') {
+      auto value = reinterpret_cast<uintptr_t>(address);
+      found = start <= value && value < end;
+    } else if (found && line.rfind("VmFlags:", 0) == 0) {
+      return line;
+    }
+  }
+  return "";
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, MmapReadPageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  char zeros[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  {
+    PosixDiskManager dm(db_file);
+    dm.WritePage(0, data);
+    dm.WritePage(2, data);
+    dm.ShutDown();
+  }
+
+  MmapDiskManager dm(db_file);
+  // pages are served out of the mapping without a copy
+  const char *mapped = dm.GetMappedPage(2);
+  ASSERT_NE(nullptr, mapped);
+  EXPECT_EQ(std::memcmp(mapped, data, sizeof(data)), 0);
+  EXPECT_EQ(mapped, dm.GetMappedPage(0) + 2 * BUSTUB_PAGE_SIZE);
+  dm.ReadPage(1, buf);
+  EXPECT_EQ(std::memcmp(buf, zeros, sizeof(buf)), 0);
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  // tolerate read past the end of the file
+  EXPECT_EQ(nullptr, dm.GetMappedPage(3));
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(std::memcmp(buf, zeros, sizeof(buf)), 0);
+
+  // writes reach the file and show up in the mapping, pages beyond the mapping are written and read with the file
+  dm.WritePage(1, data);
+  dm.ReadPage(1, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  std::memcpy(buf, data, sizeof(buf));
+  buf[0] = 'a';
+  dm.WritePage(0, buf);
+  EXPECT_EQ('a', dm.GetMappedPage(0)[0]);
+  dm.WritePage(3, data);
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  dm.SyncPages();
+  {
+    PosixDiskManager file_dm(db_file);
+    file_dm.ReadPage(0, buf);
+    EXPECT_EQ('a', buf[0]);
+    file_dm.ReadPage(1, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    file_dm.ReadPage(3, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    file_dm.ShutDown();
+  }
+
+  // Scenario: hints apply to their range only, so scans of different pages do not override each other's hints.
+  dm.AdviseAccessPattern(0, 1, AccessPattern::SEQUENTIAL);
+  dm.AdviseAccessPattern(2, 2, AccessPattern::RANDOM);
+  EXPECT_NE(std::string::npos, GetMappingFlags(dm.GetMappedPage(0)).find(" sr"));
+  EXPECT_EQ(std::string::npos, GetMappingFlags(dm.GetMappedPage(1)).find(" sr"));
+  EXPECT_EQ(std::string::npos, GetMappingFlags(dm.GetMappedPage(1)).find(" rr"));
+  EXPECT_NE(std::string::npos, GetMappingFlags(dm.GetMappedPage(2)).find(" rr"));
+  dm.AdviseAccessPattern(0, 1, AccessPattern::NORMAL);
+  EXPECT_EQ(std::string::npos, GetMappingFlags(dm.GetMappedPage(0)).find(" sr"));
+  // ranges beyond the mapping are ignored
+  dm.AdviseAccessPattern(3, 10, AccessPattern::SEQUENTIAL);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, LzCodecTest) {
+  char page[BUSTUB_PAGE_SIZE] = {0};
+  char compressed[BUSTUB_PAGE_SIZE];
+  char buf[BUSTUB_PAGE_SIZE];
+
+  // a mostly empty page with some repetitive content compresses well and round-trips
+  const int tuple_size = 40;
+  for (int i = 0; i < 100; i++) {
+    snprintf(page + BUSTUB_PAGE_SIZE - tuple_size * (i + 1), tuple_size, "tuple %d of the table", i);
+  }
+  auto size = LzCodec::Compress(page, BUSTUB_PAGE_SIZE, compressed, sizeof(compressed));
+  ASSERT_GT(size, 0);
+  EXPECT_LT(size, BUSTUB_PAGE_SIZE / 4);
+  ASSERT_TRUE(LzCodec::Decompress(compressed, size, buf, BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(page, buf, BUSTUB_PAGE_SIZE));
+  // truncated data is rejected
+  EXPECT_FALSE(LzCodec::Decompress(compressed, size - 1, buf, BUSTUB_PAGE_SIZE));
+
+  // random data does not fit into less than a page
+  std::mt19937 rng(15445);
+  for (auto &byte : page) {
+    byte = static_cast<char>(rng());
+  }
+  EXPECT_EQ(0, LzCodec::Compress(page, BUSTUB_PAGE_SIZE, compressed, BUSTUB_PAGE_SIZE - 1));
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CompressedReadWritePageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  char noise[BUSTUB_PAGE_SIZE];
+  char zeros[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+  std::mt19937 rng(15445);
+  for (auto &byte : noise) {
+    byte = static_cast<char>(rng());
+  }
+
+  {
+    CompressedDiskManager dm(db_file);
+    dm.ReadPage(0, buf);  // tolerate empty read
+    EXPECT_EQ(std::memcmp(buf, zeros, sizeof(buf)), 0);
+
+    dm.WritePage(0, data);
+    dm.WritePage(1, data);
+    EXPECT_GT(BUSTUB_PAGE_SIZE / 16, dm.GetNumBytesWritten());
+    // page 0 outgrows its slot and moves, page 2 reuses the slot it left behind once the map is synced
+    dm.WritePage(0, noise);
+    dm.SyncPages();
+    dm.WritePage(2, data);
+    EXPECT_EQ(2 * CompressedDiskManager::SLOT_UNIT + BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+    dm.ReadPage(0, buf);
+    EXPECT_EQ(std::memcmp(buf, noise, sizeof(buf)), 0);
+    dm.ReadPage(1, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    EXPECT_EQ(4, dm.GetNumWrites());
+    // a page that still fits into its slot moves too, its old slot is free once the map pointing to the new one is
+    // durable, before that a crash could leave the map pointing to another page
+    dm.WritePage(1, data);
+    auto file_size = dm.GetDbFileSize();
+    EXPECT_LT(2 * CompressedDiskManager::SLOT_UNIT + BUSTUB_PAGE_SIZE, file_size);
+    dm.WritePage(3, data);
+    EXPECT_LT(file_size, dm.GetDbFileSize());
+    file_size = dm.GetDbFileSize();
+    dm.SyncPages();
+    dm.WritePage(4, data);
+    EXPECT_EQ(file_size, dm.GetDbFileSize());
+
+    dm.SyncPages();
+    dm.ShutDown();
+  }
+
+  // Scenario: the pages and their addresses survive reopening the file.
+  CompressedDiskManager dm(db_file);
+  for (page_id_t page_id : {1, 2, 3, 4}) {
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  }
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, noise, sizeof(buf)), 0);
+  dm.ReadPage(5, buf);
+  EXPECT_EQ(std::memcmp(buf, zeros, sizeof(buf)), 0);
+  dm.ShutDown();
+}
+
+/** Records the runs of a batched write. */
+class RunRecordingDiskManager : public PosixDiskManager {
+ public:
+  using PosixDiskManager::PosixDiskManager;
+
+  auto WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) -> bool override {
+    runs_.emplace_back(first_page_id, num_pages);
+    return PosixDiskManager::WritePages(first_page_id, pages, num_pages);
+  }
+
+  std::vector<std::pair<page_id_t, size_t>> runs_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, WritePageBatchTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  std::vector<std::vector<char>> data(6, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::string db_file("test.db");
+
+  RunRecordingDiskManager dm(db_file);
+  std::vector<std::pair<page_id_t, const char *>> batch;
+  for (page_id_t page_id : {7, 2, 3, 9, 1, 8}) {
+    auto &page_data = data[batch.size()];
+    snprintf(page_data.data(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    batch.emplace_back(page_id, page_data.data());
+  }
+  EXPECT_TRUE(dm.WritePageBatch(&batch));
+
+  // adjacent pages are written together, in page id order
+  std::vector<std::pair<page_id_t, size_t>> expected_runs{{1, 3}, {7, 3}};
+  EXPECT_EQ(expected_runs, dm.runs_);
+  EXPECT_EQ(6, dm.GetNumWrites());
+  EXPECT_EQ(10 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+  for (page_id_t page_id : {1, 2, 3, 7, 8, 9}) {
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+  }
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePageMapTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+
+  {
+    DiskManager dm(db_file);
+    dm.WritePage(0, data);
+    EXPECT_EQ(INVALID_PAGE_ID, dm.AllocateFreePage(INVALID_PAGE_ID, 1, 0));
+    dm.DeallocatePage(5);
+    dm.DeallocatePage(6);
+    dm.DeallocatePage(70);
+    dm.DeallocatePage(70);
+    EXPECT_EQ(3, dm.GetNumFreePages());
+
+    // the free page closest to the hint comes first
+    EXPECT_EQ(70, dm.AllocateFreePage(68, 1, 0));
+    EXPECT_EQ(5, dm.AllocateFreePage(INVALID_PAGE_ID, 1, 0));
+    // only pages of the asking buffer pool instance qualify
+    EXPECT_EQ(INVALID_PAGE_ID, dm.AllocateFreePage(6, 2, 1));
+    EXPECT_EQ(6, dm.AllocateFreePage(100, 2, 0));
+    EXPECT_EQ(0, dm.GetNumFreePages());
+
+    dm.DeallocatePage(3);
+    dm.DeallocatePage(130);
+    dm.ShutDown();
+  }
+
+  // Scenario: the free pages survive reopening the database.
+  {
+    PosixDiskManager dm(db_file);
+    EXPECT_EQ(2, dm.GetNumFreePages());
+    EXPECT_EQ(130, dm.AllocateFreePage(200, 1, 0));
+    dm.ShutDown();
+  }
+  {
+    DiskManager dm(db_file);
+    EXPECT_EQ(1, dm.GetNumFreePages());
+    dm.ShutDown();
+  }
+
+  // Scenario: a new database does not pick up a left over map.
+  remove("test.db");
+  DiskManager dm(db_file);
+  EXPECT_EQ(0, dm.GetNumFreePages());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ExtentAllocationTest) {
+  DiskManager dm("test.db");
+  bool reused = true;
+
+  EXPECT_EQ(0, dm.AllocateNewPage(1, 0));
+  EXPECT_EQ(BUSTUB_EXTENT_SIZE, dm.AllocateExtent(&reused));
+  EXPECT_FALSE(reused);
+  // pages outside of extents fill up their own extent, then skip the extents of tables and indexes
+  for (page_id_t expected = 1; expected < BUSTUB_EXTENT_SIZE; expected++) {
+    EXPECT_EQ(expected, dm.AllocateNewPage(1, 0));
+  }
+  EXPECT_EQ(2 * BUSTUB_EXTENT_SIZE, dm.AllocateNewPage(1, 0));
+  EXPECT_EQ(3 * BUSTUB_EXTENT_SIZE, dm.AllocateExtent(&reused));
+
+  // Scenario: an extent whose pages were all deallocated is reused before the file grows.
+  for (page_id_t page_id = BUSTUB_EXTENT_SIZE; page_id < 2 * BUSTUB_EXTENT_SIZE - 1; page_id++) {
+    dm.DeallocatePage(page_id);
+  }
+  EXPECT_EQ(4 * BUSTUB_EXTENT_SIZE, dm.AllocateExtent(&reused));
+  EXPECT_FALSE(reused);
+  dm.DeallocatePage(2 * BUSTUB_EXTENT_SIZE - 1);
+  EXPECT_EQ(BUSTUB_EXTENT_SIZE, dm.AllocateExtent(&reused));
+  EXPECT_TRUE(reused);
+  EXPECT_EQ(0, dm.GetNumFreePages());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ExtentAllocatorTest) {
+  DiskManager dm("test.db");
+  ExtentAllocator table;
+  bool reused = true;
+
+  // Scenario: an instance that used up its pages of an extent leaves the pages of the other instance to it.
+  for (page_id_t expected = 0; expected < BUSTUB_EXTENT_SIZE; expected += 2) {
+    EXPECT_EQ(expected, table.AllocatePage(&dm, 2, 0, &reused));
+    EXPECT_FALSE(reused);
+  }
+  EXPECT_EQ(BUSTUB_EXTENT_SIZE, table.AllocatePage(&dm, 2, 0, &reused));
+  EXPECT_EQ(1, table.AllocatePage(&dm, 2, 1, &reused));
+  EXPECT_EQ(3, table.GetNextPage());
+  EXPECT_EQ(0, dm.GetNumFreePages());
+
+  // Scenario: with more extents open than instances, the oldest one gives its remaining pages to the free page map.
+  for (page_id_t expected = BUSTUB_EXTENT_SIZE + 2; expected < 2 * BUSTUB_EXTENT_SIZE; expected += 2) {
+    EXPECT_EQ(expected, table.AllocatePage(&dm, 2, 0, &reused));
+  }
+  EXPECT_EQ(2 * BUSTUB_EXTENT_SIZE, table.AllocatePage(&dm, 2, 0, &reused));
+  EXPECT_EQ(BUSTUB_EXTENT_SIZE / 2 - 1, dm.GetNumFreePages());
+  EXPECT_EQ(BUSTUB_EXTENT_SIZE + 1, table.AllocatePage(&dm, 2, 1, &reused));
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AllocationAfterReopenTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+
+  {
+    DiskManager dm(db_file);
+    for (page_id_t expected = 0; expected < 3; expected++) {
+      EXPECT_EQ(expected, dm.AllocateNewPage(1, 0));
+      dm.WritePage(expected, data);
+    }
+    dm.DeallocatePage(1);
+    dm.DeallocatePage(5);
+    dm.ShutDown();
+  }
+
+  // Scenario: a reopened database hands out neither the pages in the file nor the free pages a second time.
+  {
+    PosixDiskManager dm(db_file);
+    EXPECT_EQ(7, dm.AllocateNewPage(2, 1));
+    EXPECT_EQ(6, dm.AllocateNewPage(2, 0));
+    bool reused = true;
+    EXPECT_EQ(BUSTUB_EXTENT_SIZE, dm.AllocateExtent(&reused));
+    EXPECT_FALSE(reused);
+    EXPECT_EQ(1, dm.AllocateFreePage(INVALID_PAGE_ID, 2, 1));
+    dm.ShutDown();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, OpenExtentAfterReopenTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+
+  {
+    DiskManager dm(db_file);
+    ExtentAllocator table;
+    bool reused = true;
+    for (page_id_t expected = 0; expected < 3; expected++) {
+      EXPECT_EQ(expected, table.AllocatePage(&dm, 1, 0, &reused));
+      dm.WritePage(expected, data);
+    }
+    EXPECT_EQ(0, dm.GetNumFreePages());
+    dm.ShutDown();
+  }
+
+  // Scenario: the pages of an extent that was still open when the database was closed are free after reopening it.
+  {
+    DiskManager dm(db_file);
+    EXPECT_EQ(BUSTUB_EXTENT_SIZE - 3, dm.GetNumFreePages());
+    for (page_id_t page_id = 0; page_id < 3; page_id++) {
+      EXPECT_TRUE(dm.IsHandedOut(page_id));
+    }
+    EXPECT_FALSE(dm.IsHandedOut(3));
+    EXPECT_EQ(3, dm.AllocateFreePage(INVALID_PAGE_ID, 1, 0));
+    EXPECT_EQ(BUSTUB_EXTENT_SIZE, dm.AllocateNewPage(1, 0));
+    dm.ShutDown();
+  }
+
+  // Scenario: pages reclaimed once are not reclaimed a second time.
+  {
+    DiskManager dm(db_file);
+    EXPECT_EQ(BUSTUB_EXTENT_SIZE - 4, dm.GetNumFreePages());
+    EXPECT_TRUE(dm.IsHandedOut(3));
+    dm.ShutDown();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, SimulatedLatencyTest) {
+  using std::chrono::microseconds;
+  DeviceModel model;
+  model.read_ = {microseconds(20000), microseconds(30000), 0.0, microseconds(0)};
+  model.write_ = {microseconds(100), microseconds(200), 0.5, microseconds(1000)};
+  model.queue_depth_ = 4;
+
+  char data[BUSTUB_PAGE_SIZE];
+  char buf[BUSTUB_PAGE_SIZE];
+  std::memset(data, 7, sizeof(data));
+  microseconds write_latency;
+  {
+    SimulatedDiskManager dm(model);
+    for (page_id_t page_id = 0; page_id < 4; page_id++) {
+      dm.WritePage(page_id, data);
+    }
+    write_latency = dm.GetTotalLatency();
+    EXPECT_GE(write_latency, microseconds(4 * 100));
+    EXPECT_EQ(4, dm.GetNumWrites());
+
+    // a synchronous read waits for the device
+    auto start = std::chrono::steady_clock::now();
+    dm.ReadPage(0, buf);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, model.read_.min_);
+    EXPECT_EQ(0, std::memcmp(data, buf, sizeof(buf)));
+
+    // asynchronous reads up to the queue depth are served at the same time
+    std::vector<std::vector<char>> bufs(4, std::vector<char>(BUSTUB_PAGE_SIZE));
+    std::vector<DiskRequest> requests;
+    start = std::chrono::steady_clock::now();
+    for (page_id_t page_id = 0; page_id < 4; page_id++) {
+      requests.push_back(dm.ReadPageAsync(page_id, bufs[page_id].data()));
+    }
+    for (auto &request : requests) {
+      EXPECT_TRUE(request.Wait());
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 3 * model.read_.max_);
+    EXPECT_EQ(5, dm.GetNumReads());
+    dm.ShutDown();
+  }
+
+  // the same seed gives the same latencies, another one does not
+  SimulatedDiskManager same(model);
+  model.seed_++;
+  SimulatedDiskManager other(model);
+  for (page_id_t page_id = 0; page_id < 4; page_id++) {
+    same.WritePage(page_id, data);
+    other.WritePage(page_id, data);
+  }
+  EXPECT_EQ(write_latency, same.GetTotalLatency());
+  EXPECT_NE(write_latency, other.GetTotalLatency());
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ThrowBadFileTest) {
+  EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception);
+  EXPECT_THROW(PosixDiskManager("dev/null\\/foo/bar/baz/test.db"), Exception);
+}
 
 }  // namespace bustub
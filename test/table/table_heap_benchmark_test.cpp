@@ -0,0 +1,158 @@
+/**
+ * table_heap_benchmark_test.cpp
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_compressed.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// Full-table scans per second of a table that is four times the buffer pool, scanned the way SeqScanExecutor does.
+auto SeqScanThroughputCall(DiskManager *disk_manager, page_id_t first_page_id, const Schema *schema,
+                           int num_tuples, size_t num_scans) -> double {
+  auto *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  auto *table = new TableHeap(bpm, nullptr, nullptr, first_page_id);
+  table->SetReadAheadWindow(0);
+  auto *transaction = new Transaction(0);
+
+  auto clock_start = std::chrono::steady_clock::now();
+  for (size_t scan = 0; scan < num_scans; scan++) {
+    auto strategy = std::make_shared<BufferAccessStrategy>();
+    int64_t sum = 0;
+    int num_scanned = 0;
+    for (auto itr = table->Begin(transaction, strategy); itr != table->End(); ++itr) {
+      sum += itr->GetValue(schema, 0).GetAs<int32_t>();
+      num_scanned++;
+    }
+    EXPECT_EQ(num_tuples, num_scanned);
+    EXPECT_EQ(static_cast<int64_t>(num_tuples) * (num_tuples - 1) / 2, sum);
+  }
+  auto clock_end = std::chrono::steady_clock::now();
+
+  delete transaction;
+  delete table;
+  delete bpm;
+  return static_cast<double>(num_scans) /
+         std::chrono::duration_cast<std::chrono::duration<double>>(clock_end - clock_start).count();
+}
+
+TEST(TableHeapBenchmarkTest, SeqScanThroughput) {  // NOLINT
+  const std::string db_name = "seq_scan_benchmark.db";
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 256};
+  Schema schema{{col1, col2}};
+  const int num_tuples = 5000;
+
+  // create a table of about 250 pages and write it out
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(512, disk_manager);
+  auto *table = new TableHeap(bpm, nullptr, nullptr, transaction);
+  for (int i = 0; i < num_tuples; ++i) {
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(200, 'x'))}, &schema};
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+  }
+  auto first_page_id = table->GetFirstPageId();
+  bpm->FlushAllPages();
+  delete table;
+  delete bpm;
+
+  auto fstream_scans = SeqScanThroughputCall(disk_manager, first_page_id, &schema, num_tuples, 20);
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  auto *mmap_disk_manager = new MmapDiskManager(db_name);
+  auto mmap_scans = SeqScanThroughputCall(mmap_disk_manager, first_page_id, &schema, num_tuples, 20);
+  mmap_disk_manager->ShutDown();
+  delete mmap_disk_manager;
+
+  std::cout << "This test will see how much faster full-table scans get when pages are used in place in a mapping."
+            << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  std::cout << "Disk Manager: fstream Throughput: " << fstream_scans << " scans/s" << std::endl;
+  std::cout << "Disk Manager: mmap Throughput: " << mmap_scans << " scans/s" << std::endl;
+  std::cout << "Ratio: " << mmap_scans / fstream_scans << std::endl;
+  std::cout << ">>> END" << std::endl;
+
+  delete transaction;
+  remove(db_name.c_str());
+  remove("seq_scan_benchmark.log");
+  remove("seq_scan_benchmark.fsm");
+  remove("seq_scan_benchmark.ext");
+}
+
+// Write a table of about 250 pages through the given disk manager, returning its first page.
+auto WriteTable(DiskManager *disk_manager, const Schema *schema, int num_tuples) -> page_id_t {
+  auto *transaction = new Transaction(0);
+  auto *bpm = new BufferPoolManagerInstance(512, disk_manager);
+  auto *table = new TableHeap(bpm, nullptr, nullptr, transaction);
+  for (int i = 0; i < num_tuples; ++i) {
+    auto text = std::string(100 + i % 100, static_cast<char>('a' + i % 26));
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(text)}, schema};
+    RID rid;
+    EXPECT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+  }
+  auto first_page_id = table->GetFirstPageId();
+  bpm->FlushAllPages();
+  delete table;
+  delete bpm;
+  delete transaction;
+  return first_page_id;
+}
+
+TEST(TableHeapBenchmarkTest, CompressedSeqScanThroughput) {  // NOLINT
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 256};
+  Schema schema{{col1, col2}};
+  const int num_tuples = 5000;
+
+  auto *posix_disk_manager = new PosixDiskManager("posix_scan_benchmark.db");
+  auto first_page_id = WriteTable(posix_disk_manager, &schema, num_tuples);
+  auto posix_bytes = posix_disk_manager->GetDbFileSize();
+  auto posix_scans = SeqScanThroughputCall(posix_disk_manager, first_page_id, &schema, num_tuples, 20);
+  posix_disk_manager->ShutDown();
+  delete posix_disk_manager;
+
+  auto *compressed_disk_manager = new CompressedDiskManager("compressed_scan_benchmark.db");
+  first_page_id = WriteTable(compressed_disk_manager, &schema, num_tuples);
+  auto compressed_bytes = compressed_disk_manager->GetNumBytesWritten();
+  EXPECT_LT(compressed_bytes, posix_bytes);
+  auto compressed_scans = SeqScanThroughputCall(compressed_disk_manager, first_page_id, &schema, num_tuples, 20);
+  compressed_disk_manager->ShutDown();
+  delete compressed_disk_manager;
+
+  std::cout << "This test will see how many bytes page compression saves, and what it costs full-table scans."
+            << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  std::cout << "Disk Manager: posix Bytes written: " << posix_bytes << " Throughput: " << posix_scans << " scans/s"
+            << std::endl;
+  std::cout << "Disk Manager: compressed Bytes written: " << compressed_bytes << " Throughput: " << compressed_scans
+            << " scans/s" << std::endl;
+  std::cout << "Ratio: bytes " << static_cast<double>(compressed_bytes) / static_cast<double>(posix_bytes)
+            << " throughput " << compressed_scans / posix_scans << std::endl;
+  std::cout << ">>> END" << std::endl;
+
+  for (const auto *name : {"posix_scan_benchmark", "compressed_scan_benchmark"}) {
+    for (const auto *suffix : {".db", ".log", ".fsm", ".ext", ".map"}) {
+      remove((std::string(name) + suffix).c_str());
+    }
+  }
+}
+
+}  // namespace bustub
@@ -11,14 +11,19 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <iostream>
+#include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "type/value_factory.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
 
@@ -71,4 +76,169 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapReadAheadTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 256};
+  Schema schema{{col1, col2}};
+  const int num_tuples = 2000;
+
+  // create a table of about 100 pages and write it out
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(256, disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, nullptr, nullptr, transaction);
+  for (int i = 0; i < num_tuples; ++i) {
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(200, 'x'))}, &schema};
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+  }
+  auto first_page_id = table->GetFirstPageId();
+  buffer_pool_manager->FlushAllPages();
+  delete table;
+  delete buffer_pool_manager;
+
+  for (size_t window : {static_cast<size_t>(0), TableHeap::DEFAULT_READ_AHEAD_WINDOW}) {
+    // Scenario: a cold sequential scan sees every tuple, in order.
+    buffer_pool_manager = new BufferPoolManagerInstance(256, disk_manager);
+    table = new TableHeap(buffer_pool_manager, nullptr, nullptr, first_page_id);
+    table->SetReadAheadWindow(window);
+    int num_scanned = 0;
+    for (auto itr = table->Begin(transaction); itr != table->End(); ++itr) {
+      EXPECT_EQ(num_scanned, itr->GetValue(&schema, 0).GetAs<int32_t>());
+      num_scanned++;
+    }
+    EXPECT_EQ(num_tuples, num_scanned);
+
+    // Scenario: once the scan is gone and its last request is done, every page read ahead was either reached by the
+    // scan or wasted.
+    auto stats = table->GetReadAheadStats();
+    while (stats.pages_read_ahead_ != stats.hits_ + stats.wasted_) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      stats = table->GetReadAheadStats();
+    }
+    if (window == 0) {
+      EXPECT_EQ(0, stats.pages_read_ahead_);
+    } else {
+      EXPECT_GT(stats.pages_read_ahead_, 0);
+      EXPECT_GT(stats.hits_, 0);
+    }
+    delete table;
+    delete buffer_pool_manager;
+  }
+
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapNumPagesTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 256};
+  Schema schema{{col1, col2}};
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(64, disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, nullptr, nullptr, transaction);
+  EXPECT_EQ(1, table->GetNumPages());
+  for (int i = 0; i < 500; ++i) {
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(200, 'x'))}, &schema};
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+  }
+
+  // Scenario: the count of a created table follows the page chain as the table grows.
+  size_t num_pages = 0;
+  for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID; num_pages++) {
+    auto *page = static_cast<TablePage *>(buffer_pool_manager->FetchPageReadOnly(page_id));
+    ASSERT_NE(nullptr, page);
+    auto next_page_id = page->GetNextPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  EXPECT_GT(num_pages, 1);
+  EXPECT_EQ(num_pages, table->GetNumPages());
+
+  // Scenario: the pages of an opened table are not counted.
+  auto *opened_table = new TableHeap(buffer_pool_manager, nullptr, nullptr, table->GetFirstPageId());
+  EXPECT_EQ(TableHeap::UNKNOWN_NUM_PAGES, opened_table->GetNumPages());
+
+  delete opened_table;
+  delete table;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapParallelScanTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 256};
+  Schema schema{{col1, col2}};
+  const int num_tuples = 2000;
+
+  // a table of about 100 pages, scanned from a buffer pool that holds a fraction of it
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(32, disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, nullptr, nullptr, transaction);
+  for (int i = 0; i < num_tuples; ++i) {
+    Tuple tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(200, 'x'))}, &schema};
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+  }
+
+  for (size_t num_threads : {1, 4}) {
+    // every thread gets its own list, so the visits need no latch
+    std::vector<std::vector<int32_t>> seen(num_threads);
+    EXPECT_TRUE(table->ParallelScan(num_threads, transaction, [&](size_t thread_index, Tuple &tuple) {
+      ASSERT_LT(thread_index, num_threads);
+      seen[thread_index].push_back(tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    }));
+
+    // every tuple was visited exactly once
+    std::vector<int32_t> all;
+    for (const auto &values : seen) {
+      all.insert(all.end(), values.begin(), values.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(num_tuples, all.size());
+    for (int i = 0; i < num_tuples; ++i) {
+      EXPECT_EQ(i, all[i]);
+    }
+  }
+
+  // Scenario: with two frames left, more threads than frames still scan the whole table.
+  std::vector<page_id_t> pinned_pages;
+  while (buffer_pool_manager->GetNumFreeFrames() > 2) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, buffer_pool_manager->NewPage(&page_id));
+    pinned_pages.push_back(page_id);
+  }
+  size_t num_visited = 0;
+  std::mutex visited_latch;
+  EXPECT_TRUE(table->ParallelScan(8, transaction, [&](size_t thread_index, Tuple &tuple) {
+    std::scoped_lock<std::mutex> lock(visited_latch);
+    num_visited++;
+  }));
+  EXPECT_EQ(num_tuples, num_visited);
+
+  // Scenario: with every frame pinned by someone else, the scan fails instead of waiting forever.
+  while (buffer_pool_manager->GetNumFreeFrames() > 0) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, buffer_pool_manager->NewPage(&page_id));
+    pinned_pages.push_back(page_id);
+  }
+  EXPECT_FALSE(table->ParallelScan(4, transaction, [&](size_t thread_index, Tuple &tuple) {}));
+  for (auto page_id : pinned_pages) {
+    EXPECT_TRUE(buffer_pool_manager->UnpinPage(page_id, false));
+  }
+
+  delete table;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
 }  // namespace bustub